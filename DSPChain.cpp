@@ -0,0 +1,279 @@
+#include "DSPChain.h"
+
+DSPChain::DSPChain()
+{
+    for (auto& slot : slots)
+        computeState(slot, settings, currentSampleRate.load());
+}
+
+void DSPChain::setSettings(const DSPSettings& newSettings)
+{
+    settings = newSettings;
+    computeState(slots[(size_t)writeIndex], settings, currentSampleRate.load());
+    writeIndex = middleIndex.exchange(writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+}
+
+void DSPChain::prepare(double sampleRate, int maximumBlockSize)
+{
+    currentSampleRate.store(sampleRate);
+    scratch.setSize(numLanes, juce::jmax(1, maximumBlockSize));
+
+    auto& state = slots[(size_t)readIndex];
+    computeState(state, state.settings, sampleRate);
+    reset();
+}
+
+void DSPChain::reset()
+{
+    for (auto& band : memory)
+        for (auto& m : band)
+            m = BandMemory();
+    compEnvelope = 0.0f;
+    limiterEnvelope = 0.0f;
+}
+
+void DSPChain::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    pullLatestState();
+    const auto& state = slots[(size_t)readIndex];
+
+    int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+    if (state.settings.bypass || numSamples <= 0 || numChannels == 0)
+    {
+        cpuLoad.store(0.0f, std::memory_order_relaxed);
+        return;
+    }
+
+    float* channels[maxChannels];
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[ch] = buffer.getWritePointer(ch, startSample);
+
+    // EQ and dynamics cover every output so a multichannel mix stays balanced;
+    // channels go through the filters in pairs, an odd last one paired with itself
+    for (int ch = 0; ch < numChannels; ch += numLanes)
+        processEQ(channels[ch], channels[juce::jmin(ch + 1, numChannels - 1)], numSamples, state, ch / numLanes);
+
+    processDynamics(channels, numChannels, numSamples, state);
+
+    // width is a front L/R effect
+    if (numChannels > 1 && state.settings.stereoWidth != 1.0f)
+        processWidth(channels[0], channels[1], numSamples, state.settings.stereoWidth);
+
+    // time spent vs. time the block represents
+    double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    double budget = numSamples / state.sampleRate;
+    float load = (float)(elapsed / budget);
+    cpuLoad.store(cpuLoad.load(std::memory_order_relaxed) * 0.9f + load * 0.1f, std::memory_order_relaxed);
+}
+
+void DSPChain::pullLatestState()
+{
+    if ((middleIndex.load(std::memory_order_acquire) & freshFlag) == 0)
+        return;
+
+    readIndex = middleIndex.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+    // the writer may have used a stale rate if prepare() ran in between
+    auto& state = slots[(size_t)readIndex];
+    double sampleRate = currentSampleRate.load();
+    if (state.sampleRate != sampleRate)
+        computeState(state, state.settings, sampleRate);
+}
+
+void DSPChain::processEQ(float* left, float* right, int numSamples, const State& state, int pair)
+{
+    for (size_t band = 0; band < state.coeffs.size(); ++band)
+    {
+        const auto& c = state.coeffs[band];
+        if (!c.active)
+            continue;
+
+        // transposed direct form II, both lanes updated together so the
+        // compiler can keep L/R in one vector register
+        auto& m = memory[band][(size_t)pair];
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x[numLanes] = { left[i], right[i] };
+            float y[numLanes];
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                y[lane] = c.b0 * x[lane] + m.z1[lane];
+                m.z1[lane] = c.b1 * x[lane] - c.a1 * y[lane] + m.z2[lane];
+                m.z2[lane] = c.b2 * x[lane] - c.a2 * y[lane];
+            }
+
+            left[i] = y[0];
+            right[i] = y[1];
+        }
+    }
+}
+
+void DSPChain::processDynamics(float* const* channels, int numChannels, int numSamples, const State& state)
+{
+    if (!state.compActive && !state.settings.limiterEnabled)
+        return;
+
+    float* peaks = scratch.getWritePointer(0);
+    float* gains = scratch.getWritePointer(1);
+    int chunkSize = scratch.getNumSamples();
+
+    for (int pos = 0; pos < numSamples; pos += chunkSize)
+    {
+        int n = juce::jmin(chunkSize, numSamples - pos);
+
+        // linked detector: the loudest channel drives the gain for all of them
+        juce::FloatVectorOperations::abs(peaks, channels[0] + pos, n);
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            const float* x = channels[ch] + pos;
+            for (int i = 0; i < n; ++i)
+                peaks[i] = juce::jmax(peaks[i], std::abs(x[i]));
+        }
+
+        for (int i = 0; i < n; ++i)
+            gains[i] = computeGain(peaks[i], state);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply(channels[ch] + pos, gains, n);
+    }
+
+    if (state.settings.limiterEnabled)
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::clip(channels[ch], channels[ch], -state.limiterCeiling, state.limiterCeiling, numSamples);
+}
+
+float DSPChain::computeGain(float peak, const State& state)
+{
+    float gain = 1.0f;
+
+    if (state.compActive)
+    {
+        float coeff = peak > compEnvelope ? state.compAttack : state.compRelease;
+        compEnvelope = peak + coeff * (compEnvelope - peak);
+
+        if (compEnvelope > state.compThreshold)
+        {
+            float overDb = juce::Decibels::gainToDecibels(compEnvelope) - state.compThresholdDb;
+            gain = juce::Decibels::decibelsToGain(overDb * state.compSlope);
+        }
+        gain *= state.compMakeup;
+    }
+
+    if (state.settings.limiterEnabled)
+    {
+        float level = peak * gain;
+        limiterEnvelope = juce::jmax(level, limiterEnvelope * state.limiterRelease);
+        if (limiterEnvelope > state.limiterCeiling)
+            gain *= state.limiterCeiling / limiterEnvelope;
+    }
+
+    return gain;
+}
+
+void DSPChain::processWidth(float* left, float* right, int numSamples, float width)
+{
+    float* mid = scratch.getWritePointer(0);
+    float* side = scratch.getWritePointer(1);
+    int chunkSize = scratch.getNumSamples();
+
+    // mid/side in scratch-sized chunks, all vectorised
+    for (int pos = 0; pos < numSamples; pos += chunkSize)
+    {
+        int n = juce::jmin(chunkSize, numSamples - pos);
+        float* l = left + pos;
+        float* r = right + pos;
+
+        juce::FloatVectorOperations::add(mid, l, r, n);
+        juce::FloatVectorOperations::multiply(mid, 0.5f, n);
+        juce::FloatVectorOperations::subtract(side, l, r, n);
+        juce::FloatVectorOperations::multiply(side, 0.5f * width, n);
+
+        juce::FloatVectorOperations::add(l, mid, side, n);
+        juce::FloatVectorOperations::subtract(r, mid, side, n);
+    }
+}
+
+DSPChain::Coefficients DSPChain::makeCoefficients(const DSPSettings::EQBand& band, double sampleRate)
+{
+    Coefficients c;
+    if (std::abs(band.gainDb) < 0.01f || sampleRate <= 0.0)
+        return c;
+
+    // RBJ audio EQ cookbook
+    double freq = juce::jlimit(10.0, sampleRate * 0.45, (double)band.frequency);
+    double q = juce::jmax(0.05, (double)band.q);
+    double A = std::pow(10.0, band.gainDb / 40.0);
+    double w0 = juce::MathConstants<double>::twoPi * freq / sampleRate;
+    double cosw = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * q);
+    double sqrtA2alpha = 2.0 * std::sqrt(A) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    switch (band.type)
+    {
+    case DSPSettings::BandType::lowShelf:
+        b0 = A * ((A + 1.0) - (A - 1.0) * cosw + sqrtA2alpha);
+        b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosw);
+        b2 = A * ((A + 1.0) - (A - 1.0) * cosw - sqrtA2alpha);
+        a0 = (A + 1.0) + (A - 1.0) * cosw + sqrtA2alpha;
+        a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosw);
+        a2 = (A + 1.0) + (A - 1.0) * cosw - sqrtA2alpha;
+        break;
+
+    case DSPSettings::BandType::highShelf:
+        b0 = A * ((A + 1.0) + (A - 1.0) * cosw + sqrtA2alpha);
+        b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw);
+        b2 = A * ((A + 1.0) + (A - 1.0) * cosw - sqrtA2alpha);
+        a0 = (A + 1.0) - (A - 1.0) * cosw + sqrtA2alpha;
+        a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosw);
+        a2 = (A + 1.0) - (A - 1.0) * cosw - sqrtA2alpha;
+        break;
+
+    case DSPSettings::BandType::peak:
+    default:
+        b0 = 1.0 + alpha * A;
+        b1 = -2.0 * cosw;
+        b2 = 1.0 - alpha * A;
+        a0 = 1.0 + alpha / A;
+        a1 = -2.0 * cosw;
+        a2 = 1.0 - alpha / A;
+        break;
+    }
+
+    c.b0 = (float)(b0 / a0);
+    c.b1 = (float)(b1 / a0);
+    c.b2 = (float)(b2 / a0);
+    c.a1 = (float)(a1 / a0);
+    c.a2 = (float)(a2 / a0);
+    c.active = true;
+    return c;
+}
+
+void DSPChain::computeState(State& state, const DSPSettings& s, double sampleRate)
+{
+    auto envelopeCoeff = [sampleRate](float ms)
+        {
+            double samples = juce::jmax(1.0, ms * 0.001 * sampleRate);
+            return (float)std::exp(-1.0 / samples);
+        };
+
+    state.settings = s;
+    state.sampleRate = sampleRate;
+
+    for (size_t i = 0; i < s.bands.size(); ++i)
+        state.coeffs[i] = makeCoefficients(s.bands[i], sampleRate);
+
+    state.compActive = s.compThresholdDb < 0.0f && s.compRatio > 1.0f;
+    state.compThresholdDb = s.compThresholdDb;
+    state.compThreshold = juce::Decibels::decibelsToGain(s.compThresholdDb);
+    state.compSlope = 1.0f / juce::jmax(1.0f, s.compRatio) - 1.0f;
+    state.compMakeup = juce::Decibels::decibelsToGain(s.compMakeupDb);
+    state.compAttack = envelopeCoeff(s.compAttackMs);
+    state.compRelease = envelopeCoeff(s.compReleaseMs);
+
+    state.limiterCeiling = juce::Decibels::decibelsToGain(s.limiterCeilingDb);
+    state.limiterRelease = envelopeCoeff(s.limiterReleaseMs);
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+// user-facing parameters for the post-resampler DSP stage
+struct DSPSettings
+{
+    enum class BandType { lowShelf, peak, highShelf };
+
+    struct EQBand
+    {
+        BandType type = BandType::peak;
+        float frequency = 1000.0f;
+        float gainDb = 0.0f;
+        float q = 0.707f;
+    };
+
+    static constexpr int numBands = 4;
+    std::array<EQBand, numBands> bands{ {
+        { BandType::lowShelf,  100.0f,  0.0f, 0.707f },
+        { BandType::peak,      500.0f,  0.0f, 0.9f },
+        { BandType::peak,      2500.0f, 0.0f, 0.9f },
+        { BandType::highShelf, 8000.0f, 0.0f, 0.707f } } };
+
+    float compThresholdDb = 0.0f;
+    float compRatio = 4.0f;
+    float compAttackMs = 10.0f;
+    float compReleaseMs = 120.0f;
+    float compMakeupDb = 0.0f;
+
+    bool limiterEnabled = false;   // off by default so the untouched chain is transparent
+    float limiterCeilingDb = -0.3f;
+    float limiterReleaseMs = 50.0f;
+
+    float stereoWidth = 1.0f;   // 0 = mono, 1 = unchanged, 2 = extra wide
+    bool bypass = false;
+};
+
+// EQ -> compressor -> limiter -> stereo width, run after the resampler.
+// EQ and dynamics run on every channel (linked detector); width only on 0/1.
+// Settings come from the message thread through a lock-free triple buffer,
+// so the audio thread never blocks or allocates.
+class DSPChain
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    DSPChain();
+
+    // message thread
+    void setSettings(const DSPSettings& newSettings);
+    DSPSettings getSettings() const { return settings; }
+
+    // audio thread
+    void prepare(double sampleRate, int maximumBlockSize);
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void reset();
+
+    // fraction of the block's real-time budget spent in process(), smoothed
+    float getCpuLoad() const { return cpuLoad.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int numLanes = 2;   // left/right processed side by side
+
+    struct Coefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        bool active = false;   // false for flat bands so they can be skipped
+    };
+
+    // everything the audio thread needs, precomputed on the writer side
+    struct State
+    {
+        DSPSettings settings;
+        std::array<Coefficients, DSPSettings::numBands> coeffs;
+        double sampleRate = 0.0;
+        bool compActive = false;
+        float compThreshold = 1.0f, compThresholdDb = 0.0f, compSlope = 0.0f, compMakeup = 1.0f;
+        float compAttack = 0.0f, compRelease = 0.0f;
+        float limiterCeiling = 1.0f, limiterRelease = 0.0f;
+    };
+
+    static Coefficients makeCoefficients(const DSPSettings::EQBand& band, double sampleRate);
+    static void computeState(State& state, const DSPSettings& s, double sampleRate);
+
+    void pullLatestState();
+    void processEQ(float* left, float* right, int numSamples, const State& state, int pair);
+    void processDynamics(float* const* channels, int numChannels, int numSamples, const State& state);
+    float computeGain(float peak, const State& state);
+    void processWidth(float* left, float* right, int numSamples, float width);
+
+    DSPSettings settings;   // message thread copy
+
+    // triple buffer: writer owns writeIndex, reader owns readIndex,
+    // the middle slot is swapped atomically with a "fresh" flag
+    static constexpr int indexMask = 3, freshFlag = 4;
+    std::array<State, 3> slots;
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middleIndex{ 2 };
+
+    std::atomic<double> currentSampleRate{ 44100.0 };
+
+    // filter memory per band and channel pair, lanes contiguous for vectorisation
+    struct alignas(16) BandMemory
+    {
+        float z1[numLanes]{}, z2[numLanes]{};
+    };
+    std::array<std::array<BandMemory, maxChannels / numLanes>, DSPSettings::numBands> memory;
+
+    float compEnvelope = 0.0f;
+    float limiterEnvelope = 0.0f;
+
+    juce::AudioBuffer<float> scratch;   // mid/side and detector work space, sized in prepare()
+
+    std::atomic<float> cpuLoad{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DSPChain)
+};
@@ -0,0 +1,127 @@
+#include "DownmixMatrix.h"
+
+DownmixMatrix::DownmixMatrix(int inputs, int outputs)
+    : numInputs(juce::jlimit(0, maxChannels, inputs)),
+    numOutputs(juce::jlimit(0, maxChannels, outputs))
+{
+}
+
+void DownmixMatrix::setGain(int output, int input, float gain)
+{
+    if (juce::isPositiveAndBelow(output, numOutputs) && juce::isPositiveAndBelow(input, numInputs))
+        gains[(size_t)(output * maxChannels + input)] = gain;
+}
+
+DownmixMatrix DownmixMatrix::createDefault(const juce::AudioChannelSet& inputLayout, int inputs, int outputs)
+{
+    using Type = juce::AudioChannelSet::ChannelType;
+
+    DownmixMatrix m(inputs, outputs);
+    inputs = m.numInputs;
+    outputs = m.numOutputs;
+    if (inputs == 0 || outputs == 0)
+        return m;
+
+    bool ambisonic = inputLayout.size() == inputs && inputLayout.getAmbisonicOrder() > 0;
+    const float minus3dB = juce::MathConstants<float>::sqrt2 * 0.5f;
+
+    if (outputs == 1)
+    {
+        for (int in = 0; in < inputs; ++in)
+            if (inputLayout.getTypeOfChannel(in) != Type::LFE)
+                m.setGain(0, in, 1.0f / (float)inputs);
+        return m;
+    }
+
+    if (inputs == 1)
+    {
+        m.setGain(0, 0, 1.0f);
+        m.setGain(1, 0, 1.0f);
+        return m;
+    }
+
+    if (!ambisonic && outputs >= inputs)
+    {
+        for (int ch = 0; ch < inputs; ++ch)
+            m.setGain(ch, ch, 1.0f);
+        return m;
+    }
+
+    // fold everything onto the first two outputs
+    for (int in = 0; in < inputs; ++in)
+    {
+        float l = 0.0f, r = 0.0f;
+        auto type = inputLayout.size() == inputs ? inputLayout.getTypeOfChannel(in) : Type::unknown;
+
+        switch (type)
+        {
+        case Type::left:                l = 1.0f; break;
+        case Type::right:               r = 1.0f; break;
+        case Type::centre:
+        case Type::centreSurround:
+        case Type::topMiddle:
+        case Type::topFrontCentre:
+        case Type::topRearCentre:       l = r = minus3dB; break;
+        case Type::LFE:
+        case Type::LFE2:                break;
+        case Type::leftCentre:
+        case Type::leftSurround:
+        case Type::leftSurroundSide:
+        case Type::leftSurroundRear:
+        case Type::wideLeft:
+        case Type::topFrontLeft:
+        case Type::topRearLeft:         l = minus3dB; break;
+        case Type::rightCentre:
+        case Type::rightSurround:
+        case Type::rightSurroundSide:
+        case Type::rightSurroundRear:
+        case Type::wideRight:
+        case Type::topFrontRight:
+        case Type::topRearRight:        r = minus3dB; break;
+        case Type::ambisonicACN0:       l = r = minus3dB; break;   // W
+        case Type::ambisonicACN1:       l = 0.5f; r = -0.5f; break; // Y, positive to the left
+        default:
+            // higher-order ambisonic components are dropped; unknown discrete channels alternate sides
+            if (!ambisonic && in % 2 == 0) l = minus3dB;
+            else if (!ambisonic)           r = minus3dB;
+            break;
+        }
+
+        m.setGain(0, in, l);
+        m.setGain(1, in, r);
+    }
+
+    return m;
+}
+
+void DownmixMatrix::process(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest,
+    int destStartSample, int numSamples) const
+{
+    int inputs = juce::jmin(numInputs, source.getNumChannels());
+    int outputs = juce::jmin(numOutputs, dest.getNumChannels());
+
+    for (int out = 0; out < outputs; ++out)
+    {
+        float* d = dest.getWritePointer(out, destStartSample);
+        bool written = false;
+
+        for (int in = 0; in < inputs; ++in)
+        {
+            float g = getGain(out, in);
+            if (g == 0.0f)
+                continue;
+
+            if (written)
+                juce::FloatVectorOperations::addWithMultiply(d, source.getReadPointer(in), g, numSamples);
+            else
+                juce::FloatVectorOperations::copyWithMultiply(d, source.getReadPointer(in), g, numSamples);
+            written = true;
+        }
+
+        if (!written)
+            juce::FloatVectorOperations::clear(d, numSamples);
+    }
+
+    for (int out = outputs; out < dest.getNumChannels(); ++out)
+        dest.clear(out, destStartSample, numSamples);
+}
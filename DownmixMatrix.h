@@ -0,0 +1,32 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+// Gain matrix from file channels to device outputs. Fixed size, so copying
+// one around (e.g. onto the audio thread) never allocates.
+class DownmixMatrix
+{
+public:
+    static constexpr int maxChannels = 16;   // enough for 7.1.4 and third-order ambisonics
+
+    DownmixMatrix() = default;
+    DownmixMatrix(int numInputs, int numOutputs);
+
+    // sensible default for a layout: straight through when the device has room,
+    // otherwise an ITU-style fold-down (or a basic decode for ambisonics) to stereo
+    static DownmixMatrix createDefault(const juce::AudioChannelSet& inputLayout, int numInputs, int numOutputs);
+
+    int getNumInputs() const { return numInputs; }
+    int getNumOutputs() const { return numOutputs; }
+
+    float getGain(int output, int input) const { return gains[(size_t)(output * maxChannels + input)]; }
+    void setGain(int output, int input, float gain);
+
+    // dest channels [0, numOutputs) get the mix, any further ones are cleared
+    void process(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest,
+        int destStartSample, int numSamples) const;
+
+private:
+    int numInputs = 0, numOutputs = 0;
+    std::array<float, maxChannels * maxChannels> gains{};
+};
@@ -0,0 +1,241 @@
+#include "ExportEngine.h"
+
+namespace
+{
+    constexpr int renderBlockSize = 4096;
+}
+
+//==============================================================================
+// shared between the pool thread rendering a job and the GUI reading its status
+class ExportEngine::JobInfo : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<JobInfo>;
+
+    explicit JobInfo(const ExportSettings& s) : settings(s) {}
+
+    const ExportSettings settings;
+    std::atomic<JobState> state{ JobState::queued };
+    std::atomic<float> progress{ 0.0f };
+    juce::String error;   // written before state becomes failed
+};
+
+//==============================================================================
+class ExportEngine::RenderJob : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(ExportEngine& e, JobInfo::Ptr i)
+        : juce::ThreadPoolJob("Export " + i->settings.destination.getFileName()),
+        engine(e), info(std::move(i))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        if (shouldExit())
+            return finish(JobState::cancelled);
+
+        // fail before the cleanup paths below can delete the file being read
+        if (info->settings.destination == info->settings.source)
+        {
+            info->error = "Destination is the source file";
+            return finish(JobState::failed);
+        }
+
+        info->state = JobState::running;
+        engine.sendChangeMessage();
+
+        juce::String error = render();
+
+        if (shouldExit())
+        {
+            info->settings.destination.deleteFile();
+            return finish(JobState::cancelled);
+        }
+
+        if (error.isNotEmpty())
+        {
+            info->settings.destination.deleteFile();
+            info->error = error;
+            return finish(JobState::failed);
+        }
+
+        info->progress = 1.0f;
+        return finish(JobState::finished);
+    }
+
+private:
+    JobStatus finish(JobState state)
+    {
+        info->state = state;
+        engine.sendChangeMessage();
+        return jobHasFinished;
+    }
+
+    juce::String render()
+    {
+        const auto& s = info->settings;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(engine.formatManager.createReaderFor(s.source));
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+            return "Could not open " + s.source.getFileName();
+
+        double sampleRate = reader->sampleRate;
+        auto startSample = juce::jlimit((juce::int64)0, reader->lengthInSamples, (juce::int64)(s.startSeconds * sampleRate));
+        auto endSample = s.endSeconds < 0.0 ? reader->lengthInSamples
+            : juce::jlimit(startSample, reader->lengthInSamples, (juce::int64)(s.endSeconds * sampleRate));
+        double speed = s.speed > 0.0 ? s.speed : 1.0;
+        auto totalOut = (juce::int64)((double)(endSample - startSample) / speed);
+        if (totalOut <= 0)
+            return "Nothing to export";
+
+        // same stages as PlayerAudio, minus the transport; output is always stereo
+        int numChannels = 2;
+        int fileChannels = juce::jlimit(1, DownmixMatrix::maxChannels, (int)reader->numChannels);
+        auto downmix = DownmixMatrix::createDefault(reader->getChannelLayout(), fileChannels, numChannels);
+
+        juce::AudioFormatReaderSource readerSource(reader.get(), false);
+        readerSource.setNextReadPosition(startSample);
+
+        juce::ResamplingAudioSource resampler(&readerSource, false, fileChannels);
+        resampler.setResamplingRatio(speed);
+        resampler.prepareToPlay(renderBlockSize, sampleRate);
+
+        DSPChain dsp;
+        dsp.prepare(sampleRate, renderBlockSize);
+        dsp.setSettings(s.dsp);
+
+        std::unique_ptr<juce::AudioFormat> format;
+        if (s.format == ExportSettings::Format::flac)
+            format = std::make_unique<juce::FlacAudioFormat>();
+        else
+            format = std::make_unique<juce::WavAudioFormat>();
+
+        s.destination.deleteFile();
+        auto stream = s.destination.createOutputStream();
+        if (stream == nullptr)
+            return "Could not write " + s.destination.getFullPathName();
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+            (unsigned int)numChannels, s.bitsPerSample, reader->metadataValues, 0));
+        if (writer == nullptr)
+            return "Unsupported output format";
+        stream.release();   // the writer owns it now
+
+        juce::AudioBuffer<float> work(fileChannels, renderBlockSize);
+        juce::AudioBuffer<float> buffer(numChannels, renderBlockSize);
+        float lastReported = 0.0f;
+
+        for (juce::int64 written = 0; written < totalOut;)
+        {
+            if (shouldExit())
+                return {};
+
+            int n = (int)juce::jmin((juce::int64)renderBlockSize, totalOut - written);
+            resampler.getNextAudioBlock(juce::AudioSourceChannelInfo(&work, 0, n));
+            downmix.process(work, buffer, 0, n);
+            dsp.process(buffer, 0, n);
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, n))
+                return "Write failed for " + s.destination.getFileName();
+
+            written += n;
+            float progress = (float)written / (float)totalOut;
+            info->progress = progress;
+
+            // don't flood the message thread
+            if (progress - lastReported >= 0.01f)
+            {
+                lastReported = progress;
+                engine.sendChangeMessage();
+            }
+        }
+
+        resampler.releaseResources();
+        return {};
+    }
+
+    ExportEngine& engine;
+    JobInfo::Ptr info;
+
+    JUCE_DECLARE_NON_COPYABLE(RenderJob)
+};
+
+//==============================================================================
+ExportEngine::ExportEngine()
+    : pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))
+{
+    formatManager.registerBasicFormats();
+}
+
+ExportEngine::~ExportEngine()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+void ExportEngine::addJob(const ExportSettings& settings)
+{
+    JobInfo::Ptr info = new JobInfo(settings);
+    {
+        const juce::ScopedLock sl(lock);
+        jobs.add(info);
+    }
+
+    pool.addJob(new RenderJob(*this, info), true);
+    sendChangeMessage();
+}
+
+void ExportEngine::cancelAll()
+{
+    // queued jobs never run; running ones stop at the next block and remove their file
+    pool.removeAllJobs(true, 0);
+
+    const juce::ScopedLock sl(lock);
+    for (auto* job : jobs)
+        if (job->state == JobState::queued)
+            job->state = JobState::cancelled;
+
+    sendChangeMessage();
+}
+
+void ExportEngine::clearCompleted()
+{
+    const juce::ScopedLock sl(lock);
+    for (int i = jobs.size(); --i >= 0;)
+    {
+        auto state = jobs.getUnchecked(i)->state.load();
+        if (state != JobState::queued && state != JobState::running)
+            jobs.remove(i);
+    }
+}
+
+juce::Array<ExportEngine::JobReport> ExportEngine::getStatus() const
+{
+    juce::Array<JobReport> result;
+
+    const juce::ScopedLock sl(lock);
+    for (auto* job : jobs)
+    {
+        JobReport status;
+        status.destination = job->settings.destination;
+        status.state = job->state;
+        status.progress = job->progress;
+        if (status.state == JobState::failed)
+            status.error = job->error;
+        result.add(status);
+    }
+
+    return result;
+}
+
+bool ExportEngine::isBusy() const
+{
+    const juce::ScopedLock sl(lock);
+    for (auto* job : jobs)
+    {
+        auto state = job->state.load();
+        if (state == JobState::queued || state == JobState::running)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <JuceHeader.h>
+#include "DSPChain.h"
+#include "DownmixMatrix.h"
+
+struct ExportSettings
+{
+    enum class Format { wav, flac };
+
+    juce::File source, destination;
+    double startSeconds = 0.0;
+    double endSeconds = -1.0;   // < 0 renders to the end of the file
+    double speed = 1.0;
+    DSPSettings dsp;
+    Format format = Format::wav;
+    int bitsPerSample = 24;
+};
+
+// Offline renderer: reader -> resampler (speed) -> DSPChain -> AudioFormatWriter,
+// the same chain the live player runs, pulled as fast as the disk and CPU allow.
+// Jobs run in parallel on a thread pool; listeners get a change message whenever
+// a job makes progress or finishes.
+class ExportEngine : public juce::ChangeBroadcaster
+{
+public:
+    enum class JobState { queued, running, finished, failed, cancelled };
+
+    struct JobReport
+    {
+        juce::File destination;
+        JobState state = JobState::queued;
+        float progress = 0.0f;
+        juce::String error;
+    };
+
+    ExportEngine();
+    ~ExportEngine() override;
+
+    void addJob(const ExportSettings& settings);
+    void cancelAll();
+
+    // drops finished, failed and cancelled jobs from the status list
+    void clearCompleted();
+
+    // snapshot for the GUI
+    juce::Array<JobReport> getStatus() const;
+    bool isBusy() const;
+
+private:
+    class JobInfo;
+    class RenderJob;
+
+    juce::AudioFormatManager formatManager;
+    juce::ThreadPool pool;
+
+    juce::CriticalSection lock;
+    juce::ReferenceCountedArray<JobInfo> jobs;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ExportEngine)
+};
@@ -9,7 +9,10 @@ public:
     {
         addAndMakeVisible(playerGUI);
         setSize(600, 800);
-        setAudioChannels(0, 2);
+        // ask for as many outputs as we can route to; the device opens what it has
+        setAudioChannels(0, PlayerAudio::maxChannels);
+
+        playerGUI.getTelemetry().setXRunCounter([this] { return deviceManager.getXRunCount(); });
     }
 
     ~MainComponent() override
@@ -19,6 +22,9 @@ public:
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override
     {
+        if (auto* device = deviceManager.getCurrentAudioDevice())
+            playerGUI.getPlayerAudio().setOutputChannelCount(device->getActiveOutputChannels().countNumberOfSetBits());
+
         playerGUI.getPlayerAudio().prepareToPlay(samplesPerBlockExpected, sampleRate);
     }
 
@@ -3,7 +3,9 @@
 PlayerAudio::PlayerAudio()
 {
     formatManager.registerBasicFormats();
-    resamplingSource = std::make_unique<juce::ResamplingAudioSource>(&transportSource, false, 2);
+    resamplingSource = std::make_unique<juce::ResamplingAudioSource>(&transportSource, false, maxChannels);
+    activeDownmix = DownmixMatrix::createDefault(fileLayout, fileChannels, outputChannels);
+    pendingDownmix = activeDownmix;
 }
 
 PlayerAudio::~PlayerAudio()
@@ -15,17 +17,35 @@ PlayerAudio::~PlayerAudio()
 AudioFileInfo PlayerAudio::loadFile(const juce::File& file)
 {
     AudioFileInfo info;
+    loadStartedMs = juce::Time::getMillisecondCounterHiRes();
 
     transportSource.stop();
     transportSource.setSource(nullptr);
     readerSource.reset();
+    currentFile = juce::File();
 
     auto* reader = formatManager.createReaderFor(file);
     if (reader != nullptr)
     {
         readerSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
+        currentFile = file;
 
-        transportSource.setSource(readerSource.get(), 0, nullptr, reader->sampleRate);
+        {
+            const juce::SpinLock::ScopedLockType sl(downmixLock);
+            fileChannels = juce::jlimit(1, maxChannels, (int)reader->numChannels);
+            fileLayout = reader->getChannelLayout();
+            rebuildDefaultDownmix();
+        }
+
+        // setSource builds a fresh rate-converting resampler inside the transport; size the
+        // transport for this file's rate first so that resampler never grows on the audio thread
+        fileSampleRate.store(reader->sampleRate);
+        auto blockSize = deviceBlockSize.load();
+        auto deviceRate = deviceSampleRate.load();
+        if (blockSize > 0)
+            transportSource.prepareToPlay(transportBlockSize(blockSize, deviceRate), deviceRate);
+
+        transportSource.setSource(readerSource.get(), 0, nullptr, reader->sampleRate, fileChannels);
 
         // metadata
         auto& meta = reader->metadataValues;
@@ -55,8 +75,18 @@ AudioFileInfo PlayerAudio::loadFile(const juce::File& file)
         int secs = static_cast<int>(std::fmod(lengthSecs, 60.0));
         info.durationString = juce::String::formatted("%02d:%02d", mins, secs);
 
+        // format
+        auto layoutName = fileLayout.size() == fileChannels ? fileLayout.getDescription() : juce::String("Discrete");
+        info.formatString = layoutName + " (" + juce::String(fileChannels) + " ch), "
+            + juce::String(reader->sampleRate / 1000.0, 1) + " kHz, "
+            + juce::String(reader->bitsPerSample) + "-bit" + (reader->usesFloatingPointData ? " float" : "");
+
         // reset position
-        transportSource.setPosition(0.0);
+        setTransportPosition(0.0);
+
+        firstAudioMs.store(-1.0);
+        awaitingFirstAudio.store(true);
+        info.loadTimeMs = juce::Time::getMillisecondCounterHiRes() - loadStartedMs;
     }
     else
     {
@@ -72,16 +102,16 @@ void PlayerAudio::pause() { transportSource.stop(); }
 void PlayerAudio::stop()
 {
     transportSource.stop();
-    transportSource.setPosition(0.0);
+    setTransportPosition(0.0);
 }
 
 void PlayerAudio::restart()
 {
-    transportSource.setPosition(0.0);
+    setTransportPosition(0.0);
     transportSource.start();
 }
 
-void PlayerAudio::goToStart() { transportSource.setPosition(0.0); }
+void PlayerAudio::goToStart() { setTransportPosition(0.0); }
 
 void PlayerAudio::goToEnd()
 {
@@ -89,7 +119,7 @@ void PlayerAudio::goToEnd()
     {
         auto* reader = readerSource->getAudioFormatReader();
         if (reader && reader->sampleRate > 0.0)
-            transportSource.setPosition(reader->lengthInSamples / reader->sampleRate);
+            setTransportPosition(reader->lengthInSamples / reader->sampleRate);
     }
 }
 
@@ -114,17 +144,114 @@ void PlayerAudio::setLooping(bool shouldLoop)
 
 void PlayerAudio::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resamplingSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // at maxSpeed the resampler pulls twice the block from the transport, so size
+    // everything upstream for that; blocks are fed in chunks of at most this size
+    int upstreamBlock = juce::roundToInt(samplesPerBlockExpected * maxSpeed);
+    deviceBlockSize.store(samplesPerBlockExpected);
+    deviceSampleRate.store(sampleRate);
+
+    // the resampler sizes its buffer and prepares the transport from its current
+    // ratio, so prepare it at 1.0 with the maxSpeed block instead of whatever the
+    // speed slider says, then re-prepare the transport at the real device rate
+    resamplingSource->setResamplingRatio(1.0);
+    resamplingSource->prepareToPlay(upstreamBlock, sampleRate);
+    transportSource.prepareToPlay(transportBlockSize(samplesPerBlockExpected, sampleRate), sampleRate);
+    resamplingSource->setResamplingRatio(currentSpeed.load());
+
+    workBuffer.setSize(maxChannels, samplesPerBlockExpected);
+    dspChain.prepare(sampleRate, samplesPerBlockExpected);
+}
+
+int PlayerAudio::transportBlockSize(int blockSize, double deviceRate) const
+{
+    // the transport's own resampler reads fileRate / deviceRate samples per output
+    // sample, on top of the maxSpeed factor from the speed resampler
+    double fileRatio = deviceRate > 0.0 ? juce::jmax(1.0, fileSampleRate.load() / deviceRate) : 1.0;
+    return (int)std::ceil(blockSize * maxSpeed * fileRatio);
 }
 
 void PlayerAudio::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    resamplingSource->getNextAudioBlock(bufferToFill);
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (downmixChanged.load(std::memory_order_acquire))
+    {
+        juce::GenericScopedTryLock<juce::SpinLock> tryLock(downmixLock);
+        if (tryLock.isLocked())
+        {
+            activeDownmix = pendingDownmix;
+            downmixChanged.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    int numInputs = juce::jmax(1, activeDownmix.getNumInputs());
+    int chunkSize = workBuffer.getNumSamples();
+    if (chunkSize == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    for (int done = 0; done < bufferToFill.numSamples;)
+    {
+        int n = juce::jmin(chunkSize, bufferToFill.numSamples - done);
+
+        // view onto the preallocated work buffer with just the file's channels
+        juce::AudioBuffer<float> work(workBuffer.getArrayOfWritePointers(), numInputs, n);
+        resamplingSource->getNextAudioBlock(juce::AudioSourceChannelInfo(&work, 0, n));
+        activeDownmix.process(work, *bufferToFill.buffer, bufferToFill.startSample + done, n);
+
+        done += n;
+    }
+
+    dspChain.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+    publishPosition();
+    recordCallback(startTicks, bufferToFill.numSamples);
+}
+
+void PlayerAudio::recordCallback(juce::int64 startTicks, int numSamples)
+{
+    if (awaitingFirstAudio.load(std::memory_order_relaxed) && transportSource.isPlaying())
+    {
+        firstAudioMs.store(juce::Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+        awaitingFirstAudio.store(false, std::memory_order_relaxed);
+    }
+
+    double sampleRate = deviceSampleRate.load(std::memory_order_relaxed);
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    float load = (float)(elapsed * sampleRate / numSamples);
+
+    callbackLoad.store(callbackLoad.load(std::memory_order_relaxed) * 0.9f + load * 0.1f, std::memory_order_relaxed);
+
+    auto peak = callbackPeak.load(std::memory_order_relaxed);
+    while (load > peak && !callbackPeak.compare_exchange_weak(peak, load, std::memory_order_relaxed)) {}
+
+    if (load > 1.0f)
+        callbackOverruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PlayerAudio::setTransportPosition(double pos)
+{
+    // snapshots older than this are ignored by getExtrapolatedPosition()
+    lastSeekMs = juce::Time::getMillisecondCounterHiRes();
+    transportSource.setPosition(pos);
+}
+
+void PlayerAudio::publishPosition()
+{
+    snapshotSequence.fetch_add(1, std::memory_order_acq_rel);
+    snapshotPosition.store(transportSource.getCurrentPosition(), std::memory_order_relaxed);
+    snapshotTimeMs.store(juce::Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+    snapshotPlaying.store(transportSource.isPlaying(), std::memory_order_relaxed);
+    snapshotSequence.fetch_add(1, std::memory_order_release);
 }
 
 void PlayerAudio::releaseResources()
 {
+    deviceBlockSize.store(0);
     resamplingSource->releaseResources();
     transportSource.releaseResources();
 }
@@ -135,12 +262,39 @@ float PlayerAudio::getGain() const { return transportSource.getGain(); }
 double PlayerAudio::getCurrentPosition() const { return transportSource.getCurrentPosition(); }
 double PlayerAudio::getLengthInSeconds() const { return currentLength; }
 
+double PlayerAudio::getExtrapolatedPosition() const
+{
+    double pos, timeMs;
+    bool playing;
+    for (;;)
+    {
+        auto before = snapshotSequence.load(std::memory_order_acquire);
+        if ((before & 1u) != 0)
+            continue;
+
+        pos = snapshotPosition.load(std::memory_order_relaxed);
+        timeMs = snapshotTimeMs.load(std::memory_order_relaxed);
+        playing = snapshotPlaying.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (snapshotSequence.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    if (!playing || !transportSource.isPlaying() || timeMs < lastSeekMs)
+        return transportSource.getCurrentPosition();
+
+    // don't run on for long if the device stalls
+    double elapsed = juce::jlimit(0.0, 0.1, (juce::Time::getMillisecondCounterHiRes() - timeMs) * 0.001);
+    return juce::jlimit(0.0, currentLength, pos + elapsed * currentSpeed.load());
+}
+
 void PlayerAudio::setPositionSafe(double pos)
 {
     if (pos < 0.0) pos = 0.0;
     double length = getLengthInSeconds();
     if (pos > length) pos = length;
-    transportSource.setPosition(pos);
+    setTransportPosition(pos);
 }
 
 void PlayerAudio::skipForward(double seconds)
@@ -159,7 +313,73 @@ void PlayerAudio::setSpeed(double speed)
 {
     if (speed > 0.0)
     {
-        currentSpeed = speed;
+        speed = juce::jmin(speed, maxSpeed);
+        currentSpeed.store(speed);
         resamplingSource->setResamplingRatio(speed);
     }
 }
+
+PlayerAudio::CallbackStats PlayerAudio::takeCallbackStats()
+{
+    CallbackStats stats;
+    stats.averageLoad = callbackLoad.load(std::memory_order_relaxed);
+    stats.peakLoad = callbackPeak.exchange(0.0f, std::memory_order_relaxed);
+    stats.overruns = callbackOverruns.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+double PlayerAudio::takeTimeToFirstAudioMs()
+{
+    auto at = firstAudioMs.exchange(-1.0);
+    return at < 0.0 ? -1.0 : at - loadStartedMs;
+}
+
+void PlayerAudio::setOutputChannelCount(int numOutputs)
+{
+    // comes from prepareToPlay, on whichever thread (re)starts the device
+    const juce::SpinLock::ScopedLockType sl(downmixLock);
+    outputChannels = juce::jlimit(1, maxChannels, numOutputs);
+    rebuildDefaultDownmix();
+}
+
+int PlayerAudio::getFileChannelCount() const
+{
+    const juce::SpinLock::ScopedLockType sl(downmixLock);
+    return fileChannels;
+}
+
+juce::AudioChannelSet PlayerAudio::getFileChannelLayout() const
+{
+    const juce::SpinLock::ScopedLockType sl(downmixLock);
+    return fileLayout;
+}
+
+DownmixMatrix PlayerAudio::getDownmixMatrix() const
+{
+    const juce::SpinLock::ScopedLockType sl(downmixLock);
+    return pendingDownmix;
+}
+
+void PlayerAudio::setDownmixMatrix(const DownmixMatrix& matrix)
+{
+    const juce::SpinLock::ScopedLockType sl(downmixLock);
+    customDownmix = true;
+    pendingDownmix = matrix;
+    downmixChanged.store(true, std::memory_order_release);
+}
+
+void PlayerAudio::useDefaultDownmix()
+{
+    const juce::SpinLock::ScopedLockType sl(downmixLock);
+    customDownmix = false;
+    rebuildDefaultDownmix();
+}
+
+void PlayerAudio::rebuildDefaultDownmix()
+{
+    if (customDownmix)
+        return;
+
+    pendingDownmix = DownmixMatrix::createDefault(fileLayout, fileChannels, outputChannels);
+    downmixChanged.store(true, std::memory_order_release);
+}
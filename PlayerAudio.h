@@ -1,14 +1,22 @@
 #pragma once
 #include <JuceHeader.h>
+#include "DSPChain.h"
+#include "DownmixMatrix.h"
 
 struct AudioFileInfo
 {
     juce::String title, artist, album, durationString;
+    juce::String formatString;   // e.g. "5.1 (6 ch), 96 kHz, 24-bit"
+    double loadTimeMs = 0.0;
 };
 
 class PlayerAudio : public juce::AudioSource
 {
 public:
+    static constexpr int maxChannels = DownmixMatrix::maxChannels;
+    static constexpr double maxSpeed = 2.0;
+    static_assert(DSPChain::maxChannels >= maxChannels, "the DSP stage must cover every output");
+
     PlayerAudio();
     ~PlayerAudio() override;
 
@@ -30,6 +38,11 @@ public:
     float getGain() const;
 
     double getCurrentPosition() const;
+    bool isPlaying() const { return transportSource.isPlaying(); }
+
+    // position published by the audio thread, advanced to "now" at the current speed;
+    // lock-free, meant for per-frame GUI updates
+    double getExtrapolatedPosition() const;
     double getLengthInSeconds() const;
     void setPositionSafe(double posInSeconds);
 
@@ -37,7 +50,30 @@ public:
     void skipBackward(double seconds);
 
     void setSpeed(double speed);
-    double getSpeed() const { return currentSpeed; }
+    double getSpeed() const { return currentSpeed.load(); }
+
+    // post-resampler EQ/dynamics/width stage
+    void setDSPSettings(const DSPSettings& settings) { dspChain.setSettings(settings); }
+    DSPSettings getDSPSettings() const { return dspChain.getSettings(); }
+    float getDSPCpuLoad() const { return dspChain.getCpuLoad(); }
+
+    // channel routing: file channels -> device outputs
+    void setOutputChannelCount(int numOutputs);
+    int getFileChannelCount() const;
+    juce::AudioChannelSet getFileChannelLayout() const;
+    DownmixMatrix getDownmixMatrix() const;
+    void setDownmixMatrix(const DownmixMatrix& matrix);   // kept until useDefaultDownmix()
+    void useDefaultDownmix();
+
+    // telemetry; the audio thread only touches atomics, so these are cheap to poll
+    struct CallbackStats
+    {
+        float averageLoad = 0.0f;   // smoothed callback time / block duration
+        float peakLoad = 0.0f;      // since the previous call
+        int overruns = 0;           // callbacks over budget since the previous call
+    };
+    CallbackStats takeCallbackStats();
+    double takeTimeToFirstAudioMs();   // load request -> first block rendered while playing, -1 if none new
 
     bool isMuted() const { return muted; }
     juce::File getCurrentFile() const { return currentFile; }
@@ -47,12 +83,56 @@ private:
     std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
     juce::AudioTransportSource transportSource;
     std::unique_ptr<juce::ResamplingAudioSource> resamplingSource;
+    DSPChain dspChain;
 
     juce::File currentFile;
 
+    // the matrix is copied onto the audio thread under a try-lock, never waited on there.
+    // The lock also guards the routing inputs below: loadFile writes them on the message
+    // thread while prepareToPlay may run on the device thread.
+    mutable juce::SpinLock downmixLock;
+    void rebuildDefaultDownmix();   // downmixLock must be held
+    int fileChannels = 2;
+    juce::AudioChannelSet fileLayout = juce::AudioChannelSet::stereo();
+    int outputChannels = 2;
+    bool customDownmix = false;
+
+    DownmixMatrix pendingDownmix;
+    std::atomic<bool> downmixChanged{ false };
+    DownmixMatrix activeDownmix;
+
+    // sized in prepareToPlay for the widest file at full speed
+    juce::AudioBuffer<float> workBuffer;
+
+    // device settings from prepareToPlay (device thread) and the current file's rate
+    // (message thread), read by both to size the transport
+    int transportBlockSize(int blockSize, double deviceRate) const;
+    std::atomic<int> deviceBlockSize{ 0 };
+    std::atomic<double> deviceSampleRate{ 44100.0 };
+    std::atomic<double> fileSampleRate{ 0.0 };
+
+    void recordCallback(juce::int64 startTicks, int numSamples);
+    double loadStartedMs = 0.0;
+    std::atomic<float> callbackLoad{ 0.0f };
+    std::atomic<float> callbackPeak{ 0.0f };
+    std::atomic<int> callbackOverruns{ 0 };
+    std::atomic<bool> awaitingFirstAudio{ false };
+    std::atomic<double> firstAudioMs{ -1.0 };
+
+    // message-thread seeks go through here
+    void setTransportPosition(double pos);
+    double lastSeekMs = 0.0;
+
+    // seqlock-protected snapshot written once per audio block
+    void publishPosition();
+    std::atomic<unsigned int> snapshotSequence{ 0 };
+    std::atomic<double> snapshotPosition{ 0.0 };
+    std::atomic<double> snapshotTimeMs{ 0.0 };
+    std::atomic<bool> snapshotPlaying{ false };
+
     bool muted = false;
     bool looping = false;
     float previousVolume = 1.0f;
     double currentLength = 0.0;
-    double currentSpeed = 1.0;
+    std::atomic<double> currentSpeed{ 1.0 };   // also read by prepareToPlay on the device thread
 };
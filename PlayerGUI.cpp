@@ -5,7 +5,8 @@ PlayerGUI::PlayerGUI()
     // buttons and listeners
     auto buttons = { &loadButton, &playButton, &pauseButton, &stopButton, &restartButton,
                      &muteButton, &loopButton, &startButton, &endButton, &back10Button,
-                     &fwd10Button, &nextButton, &prevButton, &setAButton, &setBButton, &loopABButton };
+                     &fwd10Button, &nextButton, &prevButton, &setAButton, &setBButton, &loopABButton, &limiterButton, &hudButton,
+                     &exportButton, &exportListButton, &cancelExportButton };
 
     for (auto* b : buttons)
     {
@@ -25,7 +26,7 @@ PlayerGUI::PlayerGUI()
     progressSlider.addListener(this);
 
     addAndMakeVisible(speedSlider);
-    speedSlider.setRange(0.5, 2.0, 0.01);
+    speedSlider.setRange(0.5, PlayerAudio::maxSpeed, 0.01);
     speedSlider.setValue(1.0);
     speedSlider.addListener(this);
 
@@ -38,32 +39,106 @@ PlayerGUI::PlayerGUI()
     artistLabel.setFont(juce::Font(13.0f));
     albumLabel.setFont(juce::Font(12.0f));
     durationLabel.setFont(juce::Font(12.0f));
-    for (auto* lab : { &titleLabel, &artistLabel, &albumLabel, &durationLabel })
+    formatLabel.setFont(juce::Font(12.0f));
+    for (auto* lab : { &titleLabel, &artistLabel, &albumLabel, &durationLabel, &formatLabel })
     {
         addAndMakeVisible(lab);
         lab->setColour(juce::Label::textColourId, juce::Colours::white);
     }
 
+    // DSP knobs
+    for (auto* knob : { &eqLowSlider, &eqLowMidSlider, &eqHighMidSlider, &eqHighSlider })
+    {
+        knob->setRange(-12.0, 12.0, 0.1);
+        knob->setValue(0.0, juce::dontSendNotification);
+        knob->setTextValueSuffix(" dB");
+    }
+    compSlider.setRange(-40.0, 0.0, 0.1);
+    compSlider.setValue(0.0, juce::dontSendNotification);
+    compSlider.setTextValueSuffix(" dB");
+    widthSlider.setRange(0.0, 2.0, 0.01);
+    widthSlider.setValue(1.0, juce::dontSendNotification);
+
+    for (auto* knob : { &eqLowSlider, &eqLowMidSlider, &eqHighMidSlider, &eqHighSlider, &compSlider, &widthSlider })
+    {
+        addAndMakeVisible(knob);
+        knob->setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+        knob->setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 16);
+        knob->addListener(this);
+    }
+
+    for (auto* lab : { &eqLowLabel, &eqLowMidLabel, &eqHighMidLabel, &eqHighLabel, &compLabel, &widthLabel, &dspLoadLabel })
+    {
+        addAndMakeVisible(lab);
+        lab->setFont(juce::Font(12.0f));
+        lab->setJustificationType(juce::Justification::centred);
+        lab->setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    }
+    dspLoadLabel.setJustificationType(juce::Justification::centredLeft);
+
+    // export
+    addAndMakeVisible(exportStatusLabel);
+    exportStatusLabel.setFont(juce::Font(12.0f));
+    exportStatusLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    cancelExportButton.setVisible(false);
+    exportEngine.addChangeListener(this);
+
     // playlist box
     addAndMakeVisible(playlistBox);
     playlistBox.setModel(this);
     playlistBox.setRowHeight(26);
     playlistBox.setMultipleSelectionEnabled(false);
 
+    addAndMakeVisible(searchBox);
+    searchBox.setTextToShowWhenEmpty("Search title, artist, album or file...", juce::Colours::grey);
+    searchBox.onTextChange = [this] { applyFilter(); };
+    searchBox.onEscapeKey = [this] { searchBox.clear(); applyFilter(); };
+
+    // tags arrive in the background after the playlist is loaded
+    tagScanner.onTagsRead = [this](const std::vector<TagScanner::Tags>& batch)
+        {
+            for (auto& t : batch)
+                playlistIndex.setTrackInfo(t.index, t.title, t.artist, t.album);
+            if (!filterActive)
+                return;
+
+            // refresh the hits in place: no scrolling back to the current track
+            // while the user is browsing the results
+            filteredRows = playlistIndex.search(searchBox.getText());
+            updatingSelection = true;
+            playlistBox.updateContent();
+            auto row = rowForPlaylistIndex(currentIndex);
+            if (row >= 0)
+                playlistBox.selectRow(row, true);
+            else
+                playlistBox.deselectAllRows();
+            updatingSelection = false;
+        };
+
     // waveform
     addAndMakeVisible(waveform);
 
+    // performance overlay, hidden until toggled
+    addChildComponent(perfHud);
+    waveform.onWaveformBuilt = [this](const juce::File& f, double ms) { telemetry.waveformBuilt(f, ms); };
+    telemetry.onSnapshotChanged = [this]
+        {
+            if (perfHud.isVisible())
+                perfHud.setSnapshot(telemetry.getSnapshot());
+        };
+
     waveform.onPositionSelected = [this](double sec)
         {
             playerAudio.setPositionSafe(sec);
+            updateRefreshState();
         };
 
     setSize(1000, 520);
-    startTimerHz(25);
 }
 
 PlayerGUI::~PlayerGUI()
 {
+    exportEngine.removeChangeListener(this);
 }
 
 void PlayerGUI::paint(juce::Graphics& g)
@@ -83,7 +158,28 @@ void PlayerGUI::resized()
     auto area = getLocalBounds().reduced(8);
 
     auto playlistArea = area.removeFromRight(getWidth() / 3);
-    playlistBox.setBounds(playlistArea.reduced(8));
+
+    // DSP panel under the playlist
+    auto dspArea = playlistArea.removeFromBottom(140).reduced(8);
+    auto dspFooter = dspArea.removeFromBottom(26);
+    limiterButton.setBounds(dspFooter.removeFromLeft(100));
+    hudButton.setBounds(dspFooter.removeFromRight(60));
+    dspLoadLabel.setBounds(dspFooter.withTrimmedLeft(8));
+
+    auto dspLabels = dspArea.removeFromTop(16);
+    int knobW = dspArea.getWidth() / 6;
+    juce::Slider* knobs[] = { &eqLowSlider, &eqLowMidSlider, &eqHighMidSlider, &eqHighSlider, &compSlider, &widthSlider };
+    juce::Label* knobLabels[] = { &eqLowLabel, &eqLowMidLabel, &eqHighMidLabel, &eqHighLabel, &compLabel, &widthLabel };
+    for (int i = 0; i < 6; ++i)
+    {
+        knobLabels[i]->setBounds(dspLabels.removeFromLeft(knobW));
+        knobs[i]->setBounds(dspArea.removeFromLeft(knobW));
+    }
+
+    playlistArea.reduce(8, 8);
+    searchBox.setBounds(playlistArea.removeFromTop(26));
+    playlistArea.removeFromTop(6);
+    playlistBox.setBounds(playlistArea);
 
     auto left = area.reduced(8);
 
@@ -113,6 +209,7 @@ void PlayerGUI::resized()
     int wfTop = left.getY() + bh + 16;
     int wfHeight = 220;
     waveform.setBounds(left.getX(), wfTop, left.getWidth(), wfHeight);
+    perfHud.setBounds(left.getX() + 16, wfTop + 16, 300, 86);
 
     // progress & speed
     progressSlider.setBounds(left.getX(), wfTop + wfHeight + 8, left.getWidth(), 18);
@@ -124,6 +221,7 @@ void PlayerGUI::resized()
     artistLabel.setBounds(left.getX(), wfTop + wfHeight + 90, left.getWidth(), 18);
     albumLabel.setBounds(left.getX(), wfTop + wfHeight + 110, left.getWidth(), 18);
     durationLabel.setBounds(left.getX(), wfTop + wfHeight + 130, left.getWidth(), 18);
+    formatLabel.setBounds(left.getX(), wfTop + wfHeight + 150, left.getWidth(), 18);
 
     // bottom controls
     int bottomY = getHeight() - 108;
@@ -145,6 +243,10 @@ void PlayerGUI::resized()
     setAButton.setBounds(startX, abY, bw, bh);
     setBButton.setBounds(setAButton.getRight() + s, abY, bw, bh);
     loopABButton.setBounds(setBButton.getRight() + s, abY, bw, bh);
+    exportButton.setBounds(loopABButton.getRight() + s, abY, bw, bh);
+    exportListButton.setBounds(exportButton.getRight() + s, abY, bw, bh);
+    cancelExportButton.setBounds(exportListButton.getRight() + s, abY, bw, bh);
+    exportStatusLabel.setBounds(cancelExportButton.getRight() + s, abY, 2 * bw + s, bh);
 }
 
 void PlayerGUI::sliderValueChanged(juce::Slider* slider)
@@ -158,30 +260,122 @@ void PlayerGUI::sliderValueChanged(juce::Slider* slider)
         double len = playerAudio.getLengthInSeconds();
         if (len > 0.0)
             playerAudio.setPositionSafe(len * progressSlider.getValue());
+        updateRefreshState();
     }
     else if (slider == &speedSlider)
     {
         playerAudio.setSpeed(speedSlider.getValue());
         speedLabel.setText("Speed: " + juce::String(speedSlider.getValue(), 2) + "x", juce::dontSendNotification);
     }
+    else
+    {
+        updateDSPSettings();
+    }
+}
+
+void PlayerGUI::updateDSPSettings()
+{
+    auto settings = playerAudio.getDSPSettings();
+
+    settings.bands[0].gainDb = (float)eqLowSlider.getValue();
+    settings.bands[1].gainDb = (float)eqLowMidSlider.getValue();
+    settings.bands[2].gainDb = (float)eqHighMidSlider.getValue();
+    settings.bands[3].gainDb = (float)eqHighSlider.getValue();
+    settings.compThresholdDb = (float)compSlider.getValue();
+    settings.stereoWidth = (float)widthSlider.getValue();
+    settings.limiterEnabled = limiterEnabled;
+
+    playerAudio.setDSPSettings(settings);
+}
+
+void PlayerGUI::updateRefreshState()
+{
+    updatePositionDisplay();
+
+    if (!playerAudio.isPlaying())
+    {
+        vblankAttachment.reset();
+        stopTimer();
+    }
+    else if (!isShowing())
+    {
+        // minimised or hidden: keep A-B looping alive, nothing else. The timer is
+        // re-armed on every tick so it can wake up right when B is due
+        vblankAttachment.reset();
+        startTimer(backgroundIntervalMs());
+    }
+    else if (vblankAttachment == nullptr)
+    {
+        stopTimer();
+        vblankAttachment = std::make_unique<juce::VBlankAttachment>(this, [this] { onVBlank(); });
+    }
+}
+
+void PlayerGUI::onVBlank()
+{
+    if (!playerAudio.isPlaying() || !isShowing())
+    {
+        updateRefreshState();
+        return;
+    }
+
+    auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    if (maxRefreshHz > 0 && nowMs - lastFrameMs < 1000.0 / maxRefreshHz)
+        return;
+
+    double interval = nowMs - lastFrameMs;
+    lastFrameMs = nowMs;
+    updatePositionDisplay();
+
+    // repaints run after this callback, so the work reported is the waveform
+    // painting done since the previous frame; the first frame after idling isn't
+    // a real interval
+    double paintMs = waveform.takePaintTimeMs();
+    if (interval < 250.0)
+        telemetry.guiFrame(interval, paintMs);
+}
+
+int PlayerGUI::backgroundIntervalMs() const
+{
+    constexpr int idleIntervalMs = 250;
+    if (!abLoopEnabled || pointA < 0.0 || pointB <= pointA)
+        return idleIntervalMs;
+
+    double untilB = (pointB - playerAudio.getExtrapolatedPosition()) / juce::jmax(0.01, playerAudio.getSpeed());
+    return juce::jlimit(1, idleIntervalMs, (int)(untilB * 1000.0));
 }
 
 void PlayerGUI::timerCallback()
 {
+    // only runs while playing in the background; hands back to vsync once visible
+    updateRefreshState();
+}
+
+void PlayerGUI::updatePositionDisplay()
+{
+    dspLoadLabel.setText("DSP load: " + juce::String(playerAudio.getDSPCpuLoad() * 100.0f, 1) + "%", juce::dontSendNotification);
+
     double len = playerAudio.getLengthInSeconds();
     if (len > 0.0)
     {
-        double pos = playerAudio.getCurrentPosition();
-        progressSlider.setValue(len > 0.0 ? pos / len : 0.0, juce::dontSendNotification);
+        double pos = playerAudio.getExtrapolatedPosition();
+
+        // A-B loop enforce
+        if (abLoopEnabled && pointA >= 0.0 && pointB > pointA && pos >= pointB)
+        {
+            playerAudio.setPositionSafe(pointA);
+            pos = pointA;
+        }
+
+        if (!isShowing())
+            return;
+
+        progressSlider.setValue(pos / len, juce::dontSendNotification);
 
         // sync waveform
         waveform.setPosition(pos);
         waveform.setLength(len);
         waveform.setAB(pointA, pointB);
-
-        // A-B loop enforce
-        if (abLoopEnabled && pointA >= 0.0 && pointB > pointA && pos >= pointB)
-            playerAudio.setPositionSafe(pointA);
     }
 }
 
@@ -198,49 +392,30 @@ void PlayerGUI::buttonClicked(juce::Button* b)
 
                 playlistFiles.clear();
                 playlistNames.clear();
+                playlistIndex.clear();
+                currentIndex = -1;
 
                 for (auto& f : results)
                 {
                     playlistFiles.add(f);
                     playlistNames.add(f.getFileName());
+                    playlistIndex.addTrack(f.getFileName());
                 }
 
-                playlistBox.updateContent();
+                tagScanner.scan(playlistFiles);
+                applyFilter();
 
                 // auto load first
-                currentIndex = 0;
-                auto info = playerAudio.loadFile(playlistFiles[currentIndex]);
-                waveform.setFile(playlistFiles[currentIndex]);
-                waveform.setLength(playerAudio.getLengthInSeconds());
-
-                titleLabel.setText("Title: " + info.title, juce::dontSendNotification);
-                artistLabel.setText("Artist: " + info.artist, juce::dontSendNotification);
-                albumLabel.setText("Album: " + info.album, juce::dontSendNotification);
-                durationLabel.setText("Duration: " + info.durationString, juce::dontSendNotification);
-
-                playerAudio.play();
-                playlistBox.selectRow(currentIndex);
+                loadTrack(0);
             });
     }
     else if (b == &nextButton && currentIndex + 1 < playlistFiles.size())
     {
-        currentIndex++;
-        auto info = playerAudio.loadFile(playlistFiles[currentIndex]);
-        waveform.setFile(playlistFiles[currentIndex]);
-        playerAudio.play();
-        playlistBox.selectRow(currentIndex);
-        titleLabel.setText("Title: " + info.title, juce::dontSendNotification);
-        artistLabel.setText("Artist: " + info.artist, juce::dontSendNotification);
+        loadTrack(currentIndex + 1);
     }
     else if (b == &prevButton && currentIndex > 0)
     {
-        currentIndex--;
-        auto info = playerAudio.loadFile(playlistFiles[currentIndex]);
-        waveform.setFile(playlistFiles[currentIndex]);
-        playerAudio.play();
-        playlistBox.selectRow(currentIndex);
-        titleLabel.setText("Title: " + info.title, juce::dontSendNotification);
-        artistLabel.setText("Artist: " + info.artist, juce::dontSendNotification);
+        loadTrack(currentIndex - 1);
     }
     else if (b == &muteButton)
     {
@@ -253,6 +428,20 @@ void PlayerGUI::buttonClicked(juce::Button* b)
         playerAudio.setLooping(isLooping);
         loopButton.setButtonText(isLooping ? "Loop On" : "Loop Off");
     }
+    else if (b == &limiterButton)
+    {
+        limiterEnabled = !limiterEnabled;
+        limiterButton.setButtonText(limiterEnabled ? "Limiter On" : "Limiter Off");
+        updateDSPSettings();
+    }
+    else if (b == &hudButton)
+    {
+        perfHud.setVisible(!perfHud.isVisible());
+        perfHud.setSnapshot(telemetry.getSnapshot());
+    }
+    else if (b == &exportButton) exportCurrentTrack();
+    else if (b == &exportListButton) exportPlaylist();
+    else if (b == &cancelExportButton) exportEngine.cancelAll();
     else if (b == &playButton) playerAudio.play();
     else if (b == &pauseButton) playerAudio.pause();
     else if (b == &stopButton) playerAudio.stop();
@@ -288,12 +477,15 @@ void PlayerGUI::buttonClicked(juce::Button* b)
                 "Set valid A and B points first (B > A).");
         }
     }
+
+    updateRefreshState();
 }
 
-int PlayerGUI::getNumRows() { return playlistNames.size(); }
+int PlayerGUI::getNumRows() { return filterActive ? (int)filteredRows.size() : playlistNames.size(); }
 
 void PlayerGUI::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
 {
+    rowNumber = playlistIndexForRow(rowNumber);
     if (rowNumber < 0 || rowNumber >= playlistNames.size()) return;
 
     g.fillAll(rowIsSelected ? juce::Colour::fromRGB(48, 60, 90) : juce::Colour::fromRGB(30, 32, 36));
@@ -304,15 +496,211 @@ void PlayerGUI::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, in
 
 void PlayerGUI::selectedRowsChanged(int lastRowSelected)
 {
-    if (lastRowSelected >= 0 && lastRowSelected < playlistFiles.size())
+    if (updatingSelection) return;
+
+    loadTrack(playlistIndexForRow(lastRowSelected));
+}
+
+void PlayerGUI::loadTrack(int index)
+{
+    if (index < 0 || index >= playlistFiles.size())
+        return;
+
+    currentIndex = index;
+    auto file = playlistFiles[currentIndex];
+    auto info = playerAudio.loadFile(file);
+    if (playerAudio.getCurrentFile() == file)
+        telemetry.trackLoaded(file, info.loadTimeMs);
+    else
+        telemetry.trackLoadFailed(file);
+    waveform.setFile(file);
+    waveform.setLength(playerAudio.getLengthInSeconds());
+
+    titleLabel.setText("Title: " + info.title, juce::dontSendNotification);
+    artistLabel.setText("Artist: " + info.artist, juce::dontSendNotification);
+    albumLabel.setText("Album: " + info.album, juce::dontSendNotification);
+    durationLabel.setText("Duration: " + info.durationString, juce::dontSendNotification);
+    formatLabel.setText("Format: " + info.formatString, juce::dontSendNotification);
+
+    playerAudio.play();
+    selectCurrentRow();
+    updateRefreshState();
+}
+
+void PlayerGUI::applyFilter()
+{
+    auto query = searchBox.getText();
+    filterActive = query.trim().isNotEmpty();
+    if (filterActive)
+        filteredRows = playlistIndex.search(query);
+
+    // rebuilding the rows must not look like the user picked a track
+    updatingSelection = true;
+    playlistBox.updateContent();
+    playlistBox.deselectAllRows();
+    auto row = rowForPlaylistIndex(currentIndex);
+    if (row >= 0)
+        playlistBox.selectRow(row);
+    updatingSelection = false;
+
+    playlistBox.repaint();
+}
+
+int PlayerGUI::playlistIndexForRow(int row) const
+{
+    if (!filterActive)
+        return row;
+    return row >= 0 && row < (int)filteredRows.size() ? filteredRows[(size_t)row] : -1;
+}
+
+int PlayerGUI::rowForPlaylistIndex(int index) const
+{
+    if (index < 0 || index >= playlistFiles.size())
+        return -1;
+    if (!filterActive)
+        return index;
+
+    auto it = std::lower_bound(filteredRows.begin(), filteredRows.end(), index);
+    return it != filteredRows.end() && *it == index ? (int)(it - filteredRows.begin()) : -1;
+}
+
+void PlayerGUI::selectCurrentRow()
+{
+    // the track is already loaded; the selection must not load it a second time
+    updatingSelection = true;
+    auto row = rowForPlaylistIndex(currentIndex);
+    if (row >= 0)
+        playlistBox.selectRow(row);
+    else
+        playlistBox.deselectAllRows();
+    updatingSelection = false;
+}
+
+ExportSettings PlayerGUI::makeExportSettings(const juce::File& source) const
+{
+    ExportSettings settings;
+    settings.source = source;
+    settings.speed = playerAudio.getSpeed();
+    settings.dsp = playerAudio.getDSPSettings();
+    return settings;
+}
+
+void PlayerGUI::exportCurrentTrack()
+{
+    auto source = playerAudio.getCurrentFile();
+    if (!source.existsAsFile())
     {
-        currentIndex = lastRowSelected;
-        auto info = playerAudio.loadFile(playlistFiles[currentIndex]);
-        waveform.setFile(playlistFiles[currentIndex]);
-        playerAudio.play();
-        titleLabel.setText("Title: " + info.title, juce::dontSendNotification);
-        artistLabel.setText("Artist: " + info.artist, juce::dontSendNotification);
-        albumLabel.setText("Album: " + info.album, juce::dontSendNotification);
-        durationLabel.setText("Duration: " + info.durationString, juce::dontSendNotification);
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+            "Nothing to export",
+            "Load a track first.");
+        return;
     }
+
+    // exports the A-B region when one is set, otherwise the whole track
+    bool region = pointA >= 0.0 && pointB > pointA;
+    auto suggested = source.getSiblingFile(source.getFileNameWithoutExtension() + (region ? " (A-B).wav" : " (export).wav"));
+
+    fileChooser = std::make_unique<juce::FileChooser>("Export as...", suggested, "*.wav;*.flac");
+    fileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+        | juce::FileBrowserComponent::warnAboutOverwriting,
+        [this, source, region](const juce::FileChooser& fc)
+        {
+            auto dest = fc.getResult();
+            if (dest == juce::File{}) return;
+
+            // rendering over the file being read would destroy it
+            if (dest == source)
+            {
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                    "Invalid destination",
+                    "Choose a different file than the one being exported.");
+                return;
+            }
+
+            auto settings = makeExportSettings(source);
+            settings.destination = dest;
+            settings.format = dest.hasFileExtension("flac") ? ExportSettings::Format::flac : ExportSettings::Format::wav;
+            if (region)
+            {
+                settings.startSeconds = pointA;
+                settings.endSeconds = pointB;
+            }
+
+            if (!exportEngine.isBusy())
+                exportEngine.clearCompleted();
+            exportEngine.addJob(settings);
+        });
+}
+
+void PlayerGUI::exportPlaylist()
+{
+    if (getNumRows() == 0) return;
+
+    fileChooser = std::make_unique<juce::FileChooser>("Export playlist to folder...", juce::File{});
+    fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+        [this](const juce::FileChooser& fc)
+        {
+            auto folder = fc.getResult();
+            if (!folder.isDirectory()) return;
+
+            if (!exportEngine.isBusy())
+                exportEngine.clearCompleted();
+
+            // everything currently shown in the (possibly filtered) list. Nothing is
+            // written until the jobs run, so names handed out in this batch are
+            // tracked here to keep "a.mp3" and "a.flac" from sharing "a.wav"
+            juce::StringArray reserved;
+            for (int row = 0; row < getNumRows(); ++row)
+            {
+                auto source = playlistFiles[playlistIndexForRow(row)];
+                auto name = source.getFileNameWithoutExtension();
+                auto dest = folder.getChildFile(name + ".wav");
+                for (int n = 2; dest.exists() || reserved.contains(dest.getFileName(), true); ++n)
+                    dest = folder.getChildFile(name + " (" + juce::String(n) + ").wav");
+                reserved.add(dest.getFileName());
+
+                auto settings = makeExportSettings(source);
+                settings.destination = dest;
+                exportEngine.addJob(settings);
+            }
+        });
+}
+
+void PlayerGUI::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source == &exportEngine)
+        updateExportStatus();
+}
+
+void PlayerGUI::updateExportStatus()
+{
+    auto reports = exportEngine.getStatus();
+
+    int done = 0, failed = 0, active = 0;
+    float progress = 0.0f;
+    for (auto& r : reports)
+    {
+        switch (r.state)
+        {
+        case ExportEngine::JobState::finished:  ++done; break;
+        case ExportEngine::JobState::failed:    ++failed; break;
+        case ExportEngine::JobState::cancelled: break;
+        default:                                ++active; break;
+        }
+        progress += r.state == ExportEngine::JobState::finished ? 1.0f : r.progress;
+    }
+
+    cancelExportButton.setVisible(active > 0);
+
+    juce::String text;
+    if (active > 0)
+        text = "Exporting " + juce::String(done) + "/" + juce::String(reports.size())
+            + " (" + juce::String(juce::roundToInt(100.0f * progress / (float)reports.size())) + "%)";
+    else if (!reports.isEmpty())
+        text = "Exported " + juce::String(done) + " file" + (done == 1 ? "" : "s");
+
+    if (failed > 0)
+        text << ", " << failed << " failed";
+
+    exportStatusLabel.setText(text, juce::dontSendNotification);
 }
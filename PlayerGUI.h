@@ -2,69 +2,98 @@
 
 #include <JuceHeader.h>
 #include "PlayerAudio.h"
+#include "WaveformScheduler.h"
+#include "PlaylistIndex.h"
+#include "TagScanner.h"
+#include "ExportEngine.h"
+#include "Telemetry.h"
 
 class WaveformComponent : public juce::Component,
     private juce::ChangeListener
 {
 public:
     WaveformComponent()
-        : thumbnailCache(5),
-        thumbnail(512, formatManager, thumbnailCache)
     {
-        formatManager.registerBasicFormats();
-        thumbnail.addChangeListener(this);
+        scheduler.addChangeListener(this);
     }
 
     ~WaveformComponent() override
     {
-        thumbnail.removeChangeListener(this);
+        scheduler.removeChangeListener(this);
     }
 
     void setFile(const juce::File& f)
     {
         file = f;
-        thumbnail.clear();
-        if (file.existsAsFile())
-            thumbnail.setSource(new juce::FileInputSource(file));
+        currentPosition = 0.0;
+        builtReported = false;
+        data = scheduler.load(file);
+        peaksDirty = true;
         repaint();
     }
 
-    // position/length update from player
-    void setPosition(double p) { currentPosition = p; repaint(); }
-    void setLength(double l) { totalLength = l;    repaint(); }
+    // position/length update from player; only the columns the playhead crossed are repainted
+    void setPosition(double p)
+    {
+        int oldX = xForTime(currentPosition);
+        currentPosition = p;
+        scheduler.setPlayhead(p);
+        int newX = xForTime(currentPosition);
+        if (newX != oldX)
+            repaint(juce::jmin(oldX, newX) - 1, 0, std::abs(newX - oldX) + 3, getHeight());
+    }
+
+    void setLength(double l)
+    {
+        if (l == totalLength) return;
+        totalLength = l;
+        repaint();
+    }
 
     // A/B markers
-    void setAB(double a, double b) { aMarker = a; bMarker = b; repaint(); }
+    void setAB(double a, double b)
+    {
+        if (a == aMarker && b == bMarker) return;
+        aMarker = a;
+        bMarker = b;
+        repaint();
+    }
 
     // callback used when user clicks/drag on waveform to seek
     std::function<void(double)> onPositionSelected;
 
+    // called once per file when its waveform is fully built, with the build time
+    std::function<void(const juce::File&, double)> onWaveformBuilt;
+
+    // time spent in paint() since the previous call, for the frame telemetry
+    double takePaintTimeMs() { return std::exchange(paintTimeMs, 0.0); }
+
     void paint(juce::Graphics& g) override
     {
-        auto r = getLocalBounds().toFloat().reduced(6.0f);
+        auto paintStartMs = juce::Time::getMillisecondCounterHiRes();
+        paintWaveform(g);
+        paintTimeMs += juce::Time::getMillisecondCounterHiRes() - paintStartMs;
+    }
 
-        // background
-        juce::Path p;
-        p.addRoundedRectangle(r, 8.0f);
-        juce::DropShadow ds(juce::Colours::black.withAlpha(0.55f), 6, juce::Point<int>(0, 2));
-        ds.drawForPath(g, p);
+    void resized() override { peaksDirty = true; }
 
-        g.setColour(juce::Colour::fromRGB(22, 24, 28));
-        g.fillRoundedRectangle(r, 8.0f);
+    void mouseDown(const juce::MouseEvent& e) override { seekFromMouse(e.position.x); }
+    void mouseDrag(const juce::MouseEvent& e) override { seekFromMouse(e.position.x); }
+
+private:
+    void paintWaveform(juce::Graphics& g)
+    {
+        // background and peaks come from the cache; only overlays are drawn per frame
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (peaksDirty || scale != peaksScale || peaksImage.isNull())
+            renderPeaks(scale);
+        g.drawImage(peaksImage, getLocalBounds().toFloat());
 
-        if (thumbnail.getTotalLength() > 0.005)
+        if (data != nullptr && data->getLengthInSeconds() > 0.005)
         {
             auto drawR = getLocalBounds().reduced(12);
-            juce::ColourGradient grad(juce::Colour::fromRGB(0, 195, 165),
-                (float)drawR.getX(), (float)drawR.getY(),
-                juce::Colour::fromRGB(0, 155, 255),
-                (float)drawR.getRight(), (float)drawR.getBottom(),
-                false);
-            g.setGradientFill(grad);
 
-            thumbnail.drawChannels(g, drawR, 0.0, thumbnail.getTotalLength(), 0.9f);
-
-            double len = totalLength > 0.0 ? totalLength : thumbnail.getTotalLength();
+            double len = totalLength > 0.0 ? totalLength : data->getLengthInSeconds();
             double pos = currentPosition;
 
             // played overlay
@@ -105,6 +134,73 @@ public:
                 g.drawVerticalLine((int)x, drawR.getY() + 2.0f, drawR.getBottom() - 2.0f);
             }
         }
+    }
+
+    void changeListenerCallback(juce::ChangeBroadcaster*) override
+    {
+        if (data != nullptr && !builtReported && data->getBuildTimeMs() >= 0.0)
+        {
+            builtReported = true;
+            if (onWaveformBuilt) onWaveformBuilt(data->file, data->getBuildTimeMs());
+        }
+        peaksDirty = true;
+        repaint();
+    }
+
+    int xForTime(double t) const
+    {
+        double len = totalLength > 0.0 ? totalLength : (data != nullptr ? data->getLengthInSeconds() : 0.0);
+        return len > 0.0 ? (int)((t / len) * getWidth()) : 0;
+    }
+
+    // redrawn only when a chunk lands, the file changes or the size changes
+    void renderPeaks(float scale)
+    {
+        int w = juce::jmax(1, juce::roundToInt((float)getWidth() * scale));
+        int h = juce::jmax(1, juce::roundToInt((float)getHeight() * scale));
+        if (peaksImage.isNull() || peaksImage.getWidth() != w || peaksImage.getHeight() != h)
+            peaksImage = juce::Image(juce::Image::ARGB, w, h, true);
+        else
+            peaksImage.clear(peaksImage.getBounds());
+
+        peaksScale = scale;
+        peaksDirty = false;
+
+        juce::Graphics g(peaksImage);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        auto r = getLocalBounds().toFloat().reduced(6.0f);
+
+        // background
+        juce::Path p;
+        p.addRoundedRectangle(r, 8.0f);
+        juce::DropShadow ds(juce::Colours::black.withAlpha(0.55f), 6, juce::Point<int>(0, 2));
+        ds.drawForPath(g, p);
+
+        g.setColour(juce::Colour::fromRGB(22, 24, 28));
+        g.fillRoundedRectangle(r, 8.0f);
+
+        if (data != nullptr && data->getLengthInSeconds() > 0.005)
+        {
+            auto drawR = getLocalBounds().reduced(12);
+            juce::ColourGradient grad(juce::Colour::fromRGB(0, 195, 165),
+                (float)drawR.getX(), (float)drawR.getY(),
+                juce::Colour::fromRGB(0, 155, 255),
+                (float)drawR.getRight(), (float)drawR.getBottom(),
+                false);
+            g.setGradientFill(grad);
+
+            drawPeaks(g, drawR, 0.9f);
+
+            // build progress while chunks are still coming in
+            if (!data->isComplete())
+            {
+                g.setColour(juce::Colours::white.withAlpha(0.5f));
+                g.setFont(12.0f);
+                g.drawText("Building waveform " + juce::String(juce::roundToInt(data->getProgress() * 100.0f)) + "%",
+                    drawR.removeFromTop(16), juce::Justification::topRight);
+            }
+        }
         else
         {
             g.setColour(juce::Colours::white.withAlpha(0.06f));
@@ -112,25 +208,70 @@ public:
         }
     }
 
-    void mouseDown(const juce::MouseEvent& e) override { seekFromMouse(e.position.x); }
-    void mouseDrag(const juce::MouseEvent& e) override { seekFromMouse(e.position.x); }
+    // one min/max column per pixel, channels stacked; chunks that aren't built yet stay empty
+    void drawPeaks(juce::Graphics& g, juce::Rectangle<int> area, float verticalZoom)
+    {
+        int width = area.getWidth();
+        if (width <= 0) return;
 
-private:
-    void changeListenerCallback(juce::ChangeBroadcaster*) override { repaint(); }
+        float laneHeight = (float)area.getHeight() / (float)data->numChannels;
+
+        for (int ch = 0; ch < data->numChannels; ++ch)
+        {
+            float centre = (float)area.getY() + laneHeight * ((float)ch + 0.5f);
+            float halfHeight = laneHeight * 0.5f * verticalZoom;
+
+            for (int x = 0; x < width; ++x)
+            {
+                int first = (int)((juce::int64)x * data->numBuckets / width);
+                int last = juce::jmax(first + 1, (int)((juce::int64)(x + 1) * data->numBuckets / width));
+
+                float lo = 1.0f, hi = -1.0f;
+                for (int b = first; b < last; ++b)
+                {
+                    if (!data->isBucketReady(b)) continue;
+                    lo = juce::jmin(lo, data->getMin(ch, b));
+                    hi = juce::jmax(hi, data->getMax(ch, b));
+                }
+
+                if (hi < lo) continue;
+
+                float top = centre - juce::jlimit(-1.0f, 1.0f, hi) * halfHeight;
+                float bottom = centre - juce::jlimit(-1.0f, 1.0f, lo) * halfHeight;
+                g.fillRect((float)(area.getX() + x), top, 1.0f, juce::jmax(1.0f, bottom - top));
+            }
+        }
+
+        // label lanes for anything beyond plain stereo
+        if (data->numChannels > 2)
+        {
+            juce::Graphics::ScopedSaveState state(g);
+            g.setColour(juce::Colours::white.withAlpha(0.55f));
+            g.setFont(juce::jmin(11.0f, laneHeight * 0.8f));
+            for (int ch = 0; ch < data->numChannels; ++ch)
+                g.drawText(data->channelNames[ch], area.getX() + 2, (int)(area.getY() + laneHeight * (float)ch),
+                    28, (int)laneHeight, juce::Justification::centredLeft);
+        }
+    }
 
     void seekFromMouse(float mouseX)
     {
-        double len = totalLength > 0.0 ? totalLength : thumbnail.getTotalLength();
+        double len = totalLength > 0.0 ? totalLength : (data != nullptr ? data->getLengthInSeconds() : 0.0);
         if (len <= 0.0001) return;
         float x = juce::jlimit(0.0f, (float)getWidth(), mouseX);
         double pos = (double)(x / (float)getWidth()) * len;
         if (onPositionSelected) onPositionSelected(pos);
     }
 
-    juce::AudioFormatManager formatManager;
-    juce::AudioThumbnailCache thumbnailCache;
-    juce::AudioThumbnail thumbnail;
+    WaveformScheduler scheduler;
+    WaveformData::Ptr data;
     juce::File file;
+    bool builtReported = false;
+
+    juce::Image peaksImage;
+    float peaksScale = 1.0f;
+    bool peaksDirty = true;
+    double paintTimeMs = 0.0;
 
     double currentPosition = 0.0;
     double totalLength = 0.0;
@@ -138,10 +279,48 @@ private:
     double bMarker = -1.0;
 };
 
+// optional overlay with the live telemetry numbers
+class PerformanceHUD : public juce::Component
+{
+public:
+    PerformanceHUD()
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    void setSnapshot(const Telemetry::Snapshot& s) { snapshot = s; repaint(); }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.7f));
+        g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+
+        auto ms = [](double v) { return v < 0.0 ? juce::String("-") : juce::String(v, 1) + " ms"; };
+        auto pct = [](float v) { return juce::String(v * 100.0f, 1) + "%"; };
+
+        juce::StringArray lines;
+        lines.add("Load " + ms(snapshot.loadMs) + "   First audio " + ms(snapshot.firstAudioMs));
+        lines.add("Waveform " + ms(snapshot.waveformMs));
+        lines.add("Audio CPU " + pct(snapshot.callbackLoad) + " (peak " + pct(snapshot.callbackPeak) + ")");
+        lines.add("Overruns " + juce::String(snapshot.overruns) + "   XRuns " + juce::String(snapshot.xruns));
+        lines.add("Frame " + ms(snapshot.frameMs) + " (max " + ms(snapshot.frameMaxMs) + ", work " + ms(snapshot.frameWorkMs) + ")");
+
+        g.setColour(juce::Colours::lightgreen);
+        g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+        auto area = getLocalBounds().reduced(8, 6);
+        for (auto& line : lines)
+            g.drawText(line, area.removeFromTop(15), juce::Justification::centredLeft);
+    }
+
+private:
+    Telemetry::Snapshot snapshot;
+};
+
 class PlayerGUI : public juce::Component,
     public juce::Button::Listener,
     public juce::Slider::Listener,
     public juce::ListBoxModel,
+    public juce::ChangeListener,
     public juce::Timer
 {
 public:
@@ -154,6 +333,7 @@ public:
     void buttonClicked(juce::Button* button) override;
     void sliderValueChanged(juce::Slider* slider) override;
     void timerCallback() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
 
     // playlist
     int getNumRows() override;
@@ -161,9 +341,38 @@ public:
     void selectedRowsChanged(int lastRowSelected) override;
 
     PlayerAudio& getPlayerAudio() noexcept { return playerAudio; }
+    Telemetry& getTelemetry() noexcept { return telemetry; }
+
+    // caps the playhead frame rate while playing; 0 follows the display refresh
+    void setMaxRefreshRate(int hz) { maxRefreshHz = juce::jmax(0, hz); }
 
 private:
+    void updateDSPSettings();
+
+    // loads a playlist entry, refreshes the labels and waveform and starts playback
+    void loadTrack(int index);
+
+    // display refresh: vsync-driven while playing and visible, a slow timer
+    // while playing but hidden, nothing at all when stopped
+    void updateRefreshState();
+    void onVBlank();
+    void updatePositionDisplay();
+    int backgroundIntervalMs() const;
+
+    // playlist filtering: list rows map onto playlist positions through the search results
+    void applyFilter();
+    int playlistIndexForRow(int row) const;
+    int rowForPlaylistIndex(int index) const;
+    void selectCurrentRow();
+
+    // offline export with the current speed and DSP settings
+    ExportSettings makeExportSettings(const juce::File& source) const;
+    void exportCurrentTrack();
+    void exportPlaylist();
+    void updateExportStatus();
+
     PlayerAudio playerAudio;
+    Telemetry telemetry{ playerAudio };
 
     juce::TextButton loadButton{ "Load" }, playButton{ "Play" }, pauseButton{ "Pause" },
         stopButton{ "Stop" }, restartButton{ "Restart" }, muteButton{ "Mute" },
@@ -171,24 +380,47 @@ private:
         back10Button{ "<10s" }, fwd10Button{ "10s>" }, nextButton{ "Next>>" }, prevButton{ "<<Prev" };
 
     juce::TextButton setAButton{ "Set A" }, setBButton{ "Set B" }, loopABButton{ "Loop A-B" };
+    juce::TextButton exportButton{ "Export" }, exportListButton{ "Export List" }, cancelExportButton{ "Cancel" };
+    juce::Label exportStatusLabel;
 
     juce::Slider volumeSlider, progressSlider, speedSlider;
-    juce::Label speedLabel, titleLabel, artistLabel, albumLabel, durationLabel;
+    juce::Label speedLabel, titleLabel, artistLabel, albumLabel, durationLabel, formatLabel;
+
+    // DSP stage (EQ gains in dB, compressor threshold, stereo width)
+    juce::Slider eqLowSlider, eqLowMidSlider, eqHighMidSlider, eqHighSlider, compSlider, widthSlider;
+    juce::Label eqLowLabel{ {}, "Low" }, eqLowMidLabel{ {}, "Lo-Mid" }, eqHighMidLabel{ {}, "Hi-Mid" },
+        eqHighLabel{ {}, "High" }, compLabel{ {}, "Comp" }, widthLabel{ {}, "Width" };
+    juce::TextButton limiterButton{ "Limiter Off" }, hudButton{ "Perf" };
+    juce::Label dspLoadLabel;
 
     juce::ListBox playlistBox;
     juce::Array<juce::File> playlistFiles;
     juce::StringArray playlistNames;
     int currentIndex = -1;
 
+    juce::TextEditor searchBox;
+    PlaylistIndex playlistIndex;
+    TagScanner tagScanner;
+    std::vector<int> filteredRows;
+    bool filterActive = false;
+    bool updatingSelection = false;   // set while rows are selected from code, not by the user
+
     WaveformComponent waveform;
+    PerformanceHUD perfHud;
 
     std::unique_ptr<juce::FileChooser> fileChooser;
+    ExportEngine exportEngine;
 
     bool abLoopEnabled = false;
     double pointA = -1.0;
     double pointB = -1.0;
 
     bool isLooping = false;
+    bool limiterEnabled = false;
+
+    std::unique_ptr<juce::VBlankAttachment> vblankAttachment;
+    int maxRefreshHz = 0;
+    double lastFrameMs = 0.0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlayerGUI)
 };
@@ -0,0 +1,269 @@
+#include "PlaylistIndex.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    // key tags keep the three kinds of postings apart in one map
+    constexpr juce::uint32 trigramTag = 0x01000000u;
+    constexpr juce::uint32 prefix1Tag = 0x02000000u;
+    constexpr juce::uint32 prefix2Tag = 0x03000000u;
+
+    bool isWordChar(unsigned char c)
+    {
+        return c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    juce::uint32 trigramKey(const char* p)
+    {
+        return trigramTag | ((juce::uint32)(unsigned char)p[0] << 16)
+            | ((juce::uint32)(unsigned char)p[1] << 8) | (juce::uint32)(unsigned char)p[2];
+    }
+
+    juce::uint32 prefixKey(const std::string& word)
+    {
+        if (word.size() == 1)
+            return prefix1Tag | (unsigned char)word[0];
+        return prefix2Tag | ((juce::uint32)(unsigned char)word[0] << 8) | (unsigned char)word[1];
+    }
+
+    std::string toLower(const juce::String& s)
+    {
+        return s.toLowerCase().toStdString();
+    }
+}
+
+void PlaylistIndex::clear()
+{
+    entries.clear();
+    postings.clear();
+    results.clear();
+    lastValid = false;
+}
+
+int PlaylistIndex::addTrack(const juce::String& fileName)
+{
+    int id = (int)entries.size();
+    Entry e;
+    e.fileName = fileName;
+    e.text = buildText(e);
+    entries.push_back(std::move(e));
+
+    std::vector<Key> keys;
+    collectKeys(entries[(size_t)id].text, keys);
+    addPostings(id, keys);
+    lastValid = false;
+    return id;
+}
+
+void PlaylistIndex::setTrackInfo(int id, const juce::String& title, const juce::String& artist, const juce::String& album)
+{
+    if (id < 0 || id >= (int)entries.size())
+        return;
+
+    auto& e = entries[(size_t)id];
+    if (e.title == title && e.artist == artist && e.album == album)
+        return;
+
+    std::vector<Key> oldKeys, newKeys;
+    collectKeys(e.text, oldKeys);
+    e.title = title;
+    e.artist = artist;
+    e.album = album;
+    e.text = buildText(e);
+    collectKeys(e.text, newKeys);
+
+    // only touch the keys that changed; the file name keys usually stay put,
+    // which keeps a full tag scan from shuffling the big postings lists
+    std::vector<Key> removed, added;
+    std::set_difference(oldKeys.begin(), oldKeys.end(), newKeys.begin(), newKeys.end(), std::back_inserter(removed));
+    std::set_difference(newKeys.begin(), newKeys.end(), oldKeys.begin(), oldKeys.end(), std::back_inserter(added));
+    removePostings(id, removed);
+    addPostings(id, added);
+    lastValid = false;
+}
+
+const std::vector<int>& PlaylistIndex::search(const juce::String& query)
+{
+    std::vector<std::string> words;
+    splitWords(toLower(query), words);
+
+    if (words.empty())
+    {
+        results.resize(entries.size());
+        for (size_t i = 0; i < results.size(); ++i)
+            results[i] = (int)i;
+        lastWords.clear();
+        lastValid = true;
+        return results;
+    }
+
+    // typing more only narrows: every earlier word is still there and at
+    // least as specific (short words are prefix matches, so they must be unchanged)
+    bool narrow = lastValid && !lastWords.empty() && words.size() >= lastWords.size();
+    for (size_t i = 0; narrow && i < lastWords.size(); ++i)
+    {
+        const auto& before = lastWords[i];
+        const auto& now = words[i];
+        narrow = before.size() >= 3 ? now.compare(0, before.size(), before) == 0 : now == before;
+    }
+
+    if (narrow)
+    {
+        results.erase(std::remove_if(results.begin(), results.end(),
+            [&](int id) { return !matches(entries[(size_t)id].text, words); }), results.end());
+    }
+    else
+    {
+        // gather one postings list per key, then intersect from the smallest
+        std::vector<const Postings*> lists;
+        bool missing = false;
+        for (const auto& w : words)
+        {
+            if (w.size() < 3)
+            {
+                auto it = postings.find(prefixKey(w));
+                if (it == postings.end()) { missing = true; break; }
+                lists.push_back(&it->second);
+            }
+            else
+            {
+                for (size_t i = 0; i + 3 <= w.size(); ++i)
+                {
+                    auto it = postings.find(trigramKey(w.data() + i));
+                    if (it == postings.end()) { missing = true; break; }
+                    lists.push_back(&it->second);
+                }
+            }
+            if (missing) break;
+        }
+
+        results.clear();
+        if (!missing && !lists.empty())
+        {
+            std::sort(lists.begin(), lists.end(), [](const Postings* a, const Postings* b) { return a->size() < b->size(); });
+
+            std::vector<int> scratch;
+            results = *lists.front();
+            for (size_t i = 1; i < lists.size() && !results.empty(); ++i)
+            {
+                scratch.clear();
+                std::set_intersection(results.begin(), results.end(), lists[i]->begin(), lists[i]->end(),
+                    std::back_inserter(scratch));
+                results.swap(scratch);
+            }
+
+            // postings are exact for prefixes and single trigrams; longer words
+            // only know their trigrams are present, not that they're adjacent
+            bool exact = std::all_of(words.begin(), words.end(), [](const std::string& w) { return w.size() <= 3; });
+            if (!exact)
+                results.erase(std::remove_if(results.begin(), results.end(),
+                    [&](int id) { return !matches(entries[(size_t)id].text, words); }), results.end());
+        }
+    }
+
+    lastWords = std::move(words);
+    lastValid = true;
+    return results;
+}
+
+std::string PlaylistIndex::buildText(const Entry& e)
+{
+    return toLower(e.title) + '\n' + toLower(e.artist) + '\n' + toLower(e.album) + '\n' + toLower(e.fileName);
+}
+
+void PlaylistIndex::collectKeys(const std::string& text, std::vector<Key>& keys)
+{
+    keys.clear();
+
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+        if (text[i] != '\n' && text[i + 1] != '\n' && text[i + 2] != '\n')
+            keys.push_back(trigramKey(text.data() + i));
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        bool wordStart = isWordChar((unsigned char)text[i]) && (i == 0 || !isWordChar((unsigned char)text[i - 1]));
+        if (!wordStart)
+            continue;
+
+        keys.push_back(prefixKey(text.substr(i, 1)));
+        if (i + 1 < text.size() && isWordChar((unsigned char)text[i + 1]))
+            keys.push_back(prefixKey(text.substr(i, 2)));
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+void PlaylistIndex::splitWords(const std::string& text, std::vector<std::string>& words)
+{
+    size_t i = 0;
+    while (i < text.size())
+    {
+        while (i < text.size() && !isWordChar((unsigned char)text[i])) ++i;
+        size_t start = i;
+        while (i < text.size() && isWordChar((unsigned char)text[i])) ++i;
+        if (i > start)
+            words.push_back(text.substr(start, i - start));
+    }
+}
+
+bool PlaylistIndex::matches(const std::string& text, const std::vector<std::string>& words)
+{
+    for (const auto& w : words)
+    {
+        if (w.size() >= 3)
+        {
+            if (text.find(w) == std::string::npos)
+                return false;
+            continue;
+        }
+
+        bool found = false;
+        for (auto pos = text.find(w); pos != std::string::npos; pos = text.find(w, pos + 1))
+        {
+            if (pos == 0 || !isWordChar((unsigned char)text[pos - 1]))
+            {
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+void PlaylistIndex::addPostings(int id, const std::vector<Key>& keys)
+{
+    for (auto k : keys)
+    {
+        auto& list = postings[k];
+        // ids are appended in order while loading; updates insert in place
+        if (list.empty() || list.back() < id)
+            list.push_back(id);
+        else
+        {
+            auto it = std::lower_bound(list.begin(), list.end(), id);
+            if (it == list.end() || *it != id)
+                list.insert(it, id);
+        }
+    }
+}
+
+void PlaylistIndex::removePostings(int id, const std::vector<Key>& keys)
+{
+    for (auto k : keys)
+    {
+        auto found = postings.find(k);
+        if (found == postings.end())
+            continue;
+
+        auto& list = found->second;
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (it != list.end() && *it == id)
+            list.erase(it);
+        if (list.empty())
+            postings.erase(found);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <JuceHeader.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Search index over the playlist. Entry ids are playlist positions.
+// Query words of three or more characters match anywhere in the title,
+// artist, album or file name (trigram postings); shorter words match the
+// start of a word (prefix postings). All words must match.
+class PlaylistIndex
+{
+public:
+    void clear();
+
+    // adds a track known only by its file name; returns its id
+    int addTrack(const juce::String& fileName);
+
+    // re-indexes a track once its tags are known; pass empty strings for missing tags
+    void setTrackInfo(int id, const juce::String& title, const juce::String& artist, const juce::String& album);
+
+    // ids of matching tracks in playlist order; an empty query matches everything
+    const std::vector<int>& search(const juce::String& query);
+
+    int size() const { return (int)entries.size(); }
+
+private:
+    struct Entry
+    {
+        juce::String fileName, title, artist, album;
+        std::string text;   // lower-cased fields joined by '\n'
+    };
+
+    using Key = juce::uint32;
+    using Postings = std::vector<int>;   // sorted ids
+
+    static std::string buildText(const Entry& e);
+    static void collectKeys(const std::string& text, std::vector<Key>& keys);
+    static void splitWords(const std::string& text, std::vector<std::string>& words);
+    static bool matches(const std::string& text, const std::vector<std::string>& words);
+
+    void addPostings(int id, const std::vector<Key>& keys);
+    void removePostings(int id, const std::vector<Key>& keys);
+
+    std::vector<Entry> entries;
+    std::unordered_map<Key, Postings> postings;
+
+    // last query, so typing more characters only filters the previous hits
+    std::vector<std::string> lastWords;
+    std::vector<int> results;
+    bool lastValid = false;
+
+    JUCE_LEAK_DETECTOR(PlaylistIndex)
+};
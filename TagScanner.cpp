@@ -0,0 +1,111 @@
+#include "TagScanner.h"
+
+namespace
+{
+    constexpr int batchSize = 64;
+}
+
+//==============================================================================
+class TagScanner::ScanJob : public juce::ThreadPoolJob
+{
+public:
+    ScanJob(TagScanner& s, const juce::Array<juce::File>& f, int gen)
+        : juce::ThreadPoolJob("Tag scan"),
+        scanner(s), weakScanner(&s), files(f), generation(gen)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        std::vector<Tags> batch;
+        batch.reserve(batchSize);
+
+        for (int i = 0; i < files.size(); ++i)
+        {
+            if (shouldExit() || scanner.generation.load() != generation)
+                return jobHasFinished;
+
+            std::unique_ptr<juce::AudioFormatReader> reader(scanner.formatManager.createReaderFor(files.getReference(i)));
+            if (reader == nullptr)
+                continue;
+
+            auto& meta = reader->metadataValues;
+            auto getMeta = [&](const juce::String& a, const juce::String& b)
+                {
+                    juce::String v = meta[a];
+                    if (v.isEmpty()) v = meta[b];
+                    return v;
+                };
+
+            Tags tags;
+            tags.index = i;
+            tags.title = getMeta("title", "TITLE");
+            tags.artist = getMeta("artist", "ARTIST");
+            tags.album = getMeta("album", "ALBUM");
+
+            // untagged files are already indexed by name
+            if (tags.title.isNotEmpty() || tags.artist.isNotEmpty() || tags.album.isNotEmpty())
+                batch.push_back(std::move(tags));
+
+            if ((int)batch.size() >= batchSize)
+                post(batch);
+        }
+
+        post(batch);
+        return jobHasFinished;
+    }
+
+private:
+    void post(std::vector<Tags>& batch)
+    {
+        if (batch.empty())
+            return;
+
+        juce::MessageManager::callAsync([weak = weakScanner, gen = generation, tags = std::move(batch)]() mutable
+            {
+                if (auto* s = weak.get())
+                    s->deliver(gen, std::move(tags));
+            });
+
+        batch = {};
+        batch.reserve(batchSize);
+    }
+
+    TagScanner& scanner;
+    juce::WeakReference<TagScanner> weakScanner;   // created on the message thread
+    const juce::Array<juce::File> files;
+    const int generation;
+
+    JUCE_DECLARE_NON_COPYABLE(ScanJob)
+};
+
+//==============================================================================
+TagScanner::TagScanner()
+{
+    formatManager.registerBasicFormats();
+}
+
+TagScanner::~TagScanner()
+{
+    cancel();
+    pool.removeAllJobs(true, 2000);
+}
+
+void TagScanner::scan(const juce::Array<juce::File>& files)
+{
+    cancel();
+    pool.addJob(new ScanJob(*this, files, generation.load()), true);
+}
+
+void TagScanner::cancel()
+{
+    // the running job notices the new generation at its next file
+    ++generation;
+    pool.removeAllJobs(true, 0);
+}
+
+void TagScanner::deliver(int gen, std::vector<Tags> batch)
+{
+    if (gen == generation.load() && onTagsRead)
+        onTagsRead(batch);
+}
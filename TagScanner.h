@@ -0,0 +1,38 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+// Reads title/artist/album tags for a whole playlist on a background thread,
+// so search covers every track rather than only the ones that have been played.
+// Only real tag values are reported; missing fields come back empty.
+class TagScanner
+{
+public:
+    struct Tags
+    {
+        int index = -1;   // playlist position
+        juce::String title, artist, album;
+    };
+
+    TagScanner();
+    ~TagScanner();
+
+    // message thread; drops whatever is still being read for the previous playlist
+    void scan(const juce::Array<juce::File>& files);
+    void cancel();
+
+    // message thread, in playlist order, a batch at a time
+    std::function<void(const std::vector<Tags>&)> onTagsRead;
+
+private:
+    class ScanJob;
+
+    void deliver(int generation, std::vector<Tags> batch);
+
+    juce::AudioFormatManager formatManager;
+    juce::ThreadPool pool{ 1 };
+    std::atomic<int> generation{ 0 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(TagScanner)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TagScanner)
+};
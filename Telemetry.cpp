@@ -0,0 +1,240 @@
+#include "Telemetry.h"
+
+namespace
+{
+    constexpr juce::int64 maxLogBytes = 1024 * 1024;
+    constexpr int numRotatedLogs = 3;   // metrics.1.jsonl ... metrics.3.jsonl
+    constexpr int summaryIntervalTicks = 10;   // seconds between summary lines
+}
+
+//==============================================================================
+// Appends queued lines to the log every couple of seconds, off the message thread.
+class Telemetry::LogWriter : private juce::Thread
+{
+public:
+    explicit LogWriter(const juce::File& f)
+        : juce::Thread("Telemetry log"), file(f)
+    {
+        startThread();
+    }
+
+    ~LogWriter() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(3000);
+    }
+
+    void append(const juce::String& line)
+    {
+        const juce::ScopedLock sl(lock);
+        pending.add(line);
+    }
+
+private:
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(2000);
+            flush();
+        }
+        flush();
+    }
+
+    void flush()
+    {
+        juce::StringArray lines;
+        {
+            const juce::ScopedLock sl(lock);
+            lines.swapWith(pending);
+        }
+        if (lines.isEmpty())
+            return;
+
+        file.getParentDirectory().createDirectory();
+        if (file.getSize() > maxLogBytes)
+            rotate();
+
+        juce::FileOutputStream out(file);   // appends to an existing file
+        if (out.failedToOpen())
+            return;
+
+        for (auto& line : lines)
+            out << line << "\n";
+    }
+
+    void rotate()
+    {
+        auto rotated = [this](int i)
+            {
+                return file.getSiblingFile(file.getFileNameWithoutExtension() + "." + juce::String(i) + file.getFileExtension());
+            };
+
+        rotated(numRotatedLogs).deleteFile();
+        for (int i = numRotatedLogs - 1; i >= 1; --i)
+            rotated(i).moveFileTo(rotated(i + 1));
+        file.moveFileTo(rotated(1));
+    }
+
+    const juce::File file;
+    juce::CriticalSection lock;
+    juce::StringArray pending;
+};
+
+//==============================================================================
+Telemetry::Telemetry(PlayerAudio& audio)
+    : playerAudio(audio)
+{
+    writer = std::make_unique<LogWriter>(getLogFile());
+
+    juce::DynamicObject::Ptr fields = new juce::DynamicObject();
+    fields->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    fields->setProperty("cpu", juce::SystemStats::getCpuModel());
+    fields->setProperty("cores", juce::SystemStats::getNumCpus());
+    log("session_start", fields);
+
+    startTimer(1000);
+}
+
+Telemetry::~Telemetry()
+{
+    stopTimer();
+    writeSummary();
+    log("session_end", new juce::DynamicObject());
+    writer.reset();
+}
+
+juce::File Telemetry::getLogFile() const
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AudioPlayer").getChildFile("metrics.jsonl");
+}
+
+void Telemetry::trackLoaded(const juce::File& file, double loadMs)
+{
+    currentTrack = file;
+    snapshot.loadMs = loadMs;
+    snapshot.firstAudioMs = -1.0;
+
+    juce::DynamicObject::Ptr fields = new juce::DynamicObject();
+    fields->setProperty("file", file.getFileName());
+    fields->setProperty("load_ms", loadMs);
+    log("track_load", fields);
+}
+
+void Telemetry::trackLoadFailed(const juce::File& file)
+{
+    currentTrack = juce::File();
+    snapshot.loadMs = -1.0;
+    snapshot.firstAudioMs = -1.0;
+
+    juce::DynamicObject::Ptr fields = new juce::DynamicObject();
+    fields->setProperty("file", file.getFileName());
+    log("load_failed", fields);
+}
+
+void Telemetry::waveformBuilt(const juce::File& file, double buildMs)
+{
+    snapshot.waveformMs = buildMs;
+
+    juce::DynamicObject::Ptr fields = new juce::DynamicObject();
+    fields->setProperty("file", file.getFileName());
+    fields->setProperty("build_ms", buildMs);
+    log("waveform", fields);
+}
+
+void Telemetry::guiFrame(double intervalMs, double workMs)
+{
+    ++windowFrames;
+    windowFrameMs += intervalMs;
+    windowWorkMs += workMs;
+    windowFrameMax = juce::jmax(windowFrameMax, intervalMs);
+
+    snapshot.frameMs = snapshot.frameMs * 0.9 + intervalMs * 0.1;
+    snapshot.frameWorkMs = snapshot.frameWorkMs * 0.9 + workMs * 0.1;
+    snapshot.frameMaxMs = windowFrameMax;
+}
+
+void Telemetry::timerCallback()
+{
+    auto firstAudio = playerAudio.takeTimeToFirstAudioMs();
+    if (firstAudio >= 0.0)
+    {
+        snapshot.firstAudioMs = firstAudio;
+
+        juce::DynamicObject::Ptr fields = new juce::DynamicObject();
+        fields->setProperty("file", currentTrack.getFileName());
+        fields->setProperty("ms", firstAudio);
+        log("first_audio", fields);
+    }
+
+    auto stats = playerAudio.takeCallbackStats();
+    snapshot.callbackLoad = stats.averageLoad;
+    snapshot.callbackPeak = stats.peakLoad;
+    snapshot.overruns += stats.overruns;
+
+    windowLoadSum += stats.averageLoad;
+    windowLoadPeak = juce::jmax(windowLoadPeak, stats.peakLoad);
+    ++windowLoadSamples;
+    windowOverruns += stats.overruns;
+    windowPlayed = windowPlayed || playerAudio.isPlaying();
+
+    if (xrunCounter)
+    {
+        // a lower count means the device was reopened and started again from zero
+        int count = juce::jmax(0, xrunCounter());
+        int delta = count >= lastDeviceXRuns ? count - lastDeviceXRuns : count;
+        lastDeviceXRuns = count;
+        snapshot.xruns += delta;
+        windowXRuns += delta;
+    }
+
+    if (++ticks >= summaryIntervalTicks)
+        writeSummary();
+
+    if (onSnapshotChanged)
+        onSnapshotChanged();
+}
+
+void Telemetry::writeSummary()
+{
+    // only worth a line if something played or went wrong
+    if (windowPlayed || windowOverruns > 0 || windowXRuns > 0)
+    {
+        juce::DynamicObject::Ptr fields = new juce::DynamicObject();
+        fields->setProperty("callback_load_avg", windowLoadSamples > 0 ? windowLoadSum / (float)windowLoadSamples : 0.0f);
+        fields->setProperty("callback_load_peak", windowLoadPeak);
+        fields->setProperty("overruns", windowOverruns);
+        fields->setProperty("xruns", windowXRuns);
+        fields->setProperty("frames", windowFrames);
+        fields->setProperty("frame_ms_avg", windowFrames > 0 ? windowFrameMs / windowFrames : 0.0);
+        fields->setProperty("frame_ms_max", windowFrameMax);
+        fields->setProperty("frame_work_ms_avg", windowFrames > 0 ? windowWorkMs / windowFrames : 0.0);
+        fields->setProperty("dsp_load", playerAudio.getDSPCpuLoad());
+        log("summary", fields);
+    }
+
+    ticks = 0;
+    windowFrames = 0;
+    windowFrameMs = windowWorkMs = windowFrameMax = 0.0;
+    windowLoadSum = windowLoadPeak = 0.0f;
+    windowLoadSamples = 0;
+    windowOverruns = 0;
+    windowXRuns = 0;
+    windowPlayed = false;
+}
+
+void Telemetry::log(const juce::String& event, juce::DynamicObject::Ptr fields)
+{
+    if (!loggingEnabled || writer == nullptr)
+        return;
+
+    juce::DynamicObject::Ptr line = new juce::DynamicObject();
+    line->setProperty("t", juce::Time::getCurrentTime().toISO8601(true));
+    line->setProperty("event", event);
+    for (auto& field : fields->getProperties())
+        line->setProperty(field.name, field.value);
+
+    writer->append(juce::JSON::toString(juce::var(line.get()), true));
+}
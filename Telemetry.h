@@ -0,0 +1,73 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PlayerAudio.h"
+
+// Collects playback and GUI performance numbers for the HUD and appends them
+// to a rotating JSON-lines log. Recording is a handful of atomics and adds on
+// the hot paths; the file is written from a background thread.
+class Telemetry : private juce::Timer
+{
+public:
+    struct Snapshot
+    {
+        double loadMs = -1.0;          // last track load
+        double firstAudioMs = -1.0;    // load request -> first rendered block
+        double waveformMs = -1.0;      // last waveform build
+        float callbackLoad = 0.0f;     // audio callback time / block duration
+        float callbackPeak = 0.0f;
+        int overruns = 0;              // callbacks that took longer than their block
+        int xruns = 0;                 // device xruns this session, summed across device restarts
+        double frameMs = 0.0;          // average interval between GUI frames
+        double frameWorkMs = 0.0;      // average time spent painting the waveform per frame
+        double frameMaxMs = 0.0;
+    };
+
+    explicit Telemetry(PlayerAudio& audio);
+    ~Telemetry() override;
+
+    void setLoggingEnabled(bool shouldLog) { loggingEnabled = shouldLog; }
+    bool isLoggingEnabled() const { return loggingEnabled; }
+    juce::File getLogFile() const;
+
+    // device xrun count, polled once a second
+    void setXRunCounter(std::function<int()> counter) { xrunCounter = std::move(counter); }
+
+    // message thread events
+    void trackLoaded(const juce::File& file, double loadMs);
+    void trackLoadFailed(const juce::File& file);
+    void waveformBuilt(const juce::File& file, double buildMs);
+    void guiFrame(double intervalMs, double workMs);
+
+    Snapshot getSnapshot() const { return snapshot; }
+
+    // called on the message thread after each once-a-second poll
+    std::function<void()> onSnapshotChanged;
+
+private:
+    class LogWriter;
+
+    void timerCallback() override;
+    void writeSummary();
+    void log(const juce::String& event, juce::DynamicObject::Ptr fields);
+
+    PlayerAudio& playerAudio;
+    std::unique_ptr<LogWriter> writer;
+    std::function<int()> xrunCounter;
+    bool loggingEnabled = true;
+
+    Snapshot snapshot;
+    juce::File currentTrack;
+
+    // per summary window
+    int ticks = 0;
+    int windowFrames = 0;
+    double windowFrameMs = 0.0, windowWorkMs = 0.0, windowFrameMax = 0.0;
+    float windowLoadSum = 0.0f, windowLoadPeak = 0.0f;
+    int windowLoadSamples = 0;
+    int windowOverruns = 0;
+    int windowXRuns = 0;
+    int lastDeviceXRuns = 0;   // the device's own count, which restarts when it reopens
+    bool windowPlayed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Telemetry)
+};
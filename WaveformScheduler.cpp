@@ -0,0 +1,212 @@
+#include "WaveformScheduler.h"
+
+namespace
+{
+    constexpr int targetBuckets = 8192;
+    constexpr int minSamplesPerBucket = 512;
+    constexpr int maxDisplayChannels = 16;
+    constexpr int maxReadSamples = 65536;   // per channel, whatever the bucket size
+
+    int chooseSamplesPerBucket(juce::int64 lengthInSamples)
+    {
+        return (int)juce::jmax((juce::int64)minSamplesPerBucket, (lengthInSamples + targetBuckets - 1) / targetBuckets);
+    }
+}
+
+//==============================================================================
+WaveformData::WaveformData(const juce::File& f, int channels, juce::int64 length, double rate)
+    : file(f),
+    numChannels(channels),
+    lengthInSamples(length),
+    sampleRate(rate),
+    samplesPerBucket(chooseSamplesPerBucket(length)),
+    numBuckets((int)juce::jmax((juce::int64)1, (length + samplesPerBucket - 1) / samplesPerBucket)),
+    numChunks((numBuckets + bucketsPerChunk - 1) / bucketsPerChunk),
+    minPeaks((size_t)(channels * numBuckets), 0.0f),
+    maxPeaks((size_t)(channels * numBuckets), 0.0f),
+    chunkStates((size_t)numChunks)
+{
+    for (auto& s : chunkStates)
+        s.store(pending, std::memory_order_relaxed);
+}
+
+int WaveformData::claimChunkNearest(int preferredChunk)
+{
+    preferredChunk = juce::jlimit(0, numChunks - 1, preferredChunk);
+
+    // walk outward from the playhead: 0, +1, -1, +2, -2 ...
+    for (int offset = 0; offset < numChunks; ++offset)
+    {
+        for (int dir : { 1, -1 })
+        {
+            int chunk = preferredChunk + dir * offset;
+            if (chunk < 0 || chunk >= numChunks)
+                continue;
+
+            int expected = pending;
+            if (chunkStates[(size_t)chunk].compare_exchange_strong(expected, claimed, std::memory_order_acq_rel))
+                return chunk;
+
+            if (offset == 0)
+                break;
+        }
+    }
+
+    return -1;
+}
+
+void WaveformData::markChunkReady(int chunk)
+{
+    chunkStates[(size_t)chunk].store(ready, std::memory_order_release);
+    if (chunksDone.fetch_add(1, std::memory_order_acq_rel) + 1 == numChunks)
+        buildTimeMs.store(juce::Time::getMillisecondCounterHiRes() - startedMs, std::memory_order_release);
+}
+
+//==============================================================================
+// One worker: keeps claiming chunks nearest the playhead until none are left
+// or the data set is superseded.
+class WaveformScheduler::BuildJob : public juce::ThreadPoolJob
+{
+public:
+    BuildJob(WaveformScheduler& s, WaveformData::Ptr d)
+        : juce::ThreadPoolJob("Waveform " + d->file.getFileName()),
+        scheduler(s), data(std::move(d))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        // readers aren't thread-safe, so every worker gets its own
+        std::unique_ptr<juce::AudioFormatReader> reader(scheduler.formatManager.createReaderFor(data->file));
+        if (reader == nullptr)
+            return jobHasFinished;
+
+        auto chunkSamples = (juce::int64)data->samplesPerBucket * WaveformData::bucketsPerChunk;
+        juce::AudioBuffer<float> block(data->numChannels, (int)juce::jmin((juce::int64)maxReadSamples, chunkSamples));
+
+        while (!shouldStop())
+        {
+            auto seconds = data->playheadSeconds.load(std::memory_order_relaxed);
+            auto preferred = (int)((seconds * data->sampleRate) / data->samplesPerBucket) / WaveformData::bucketsPerChunk;
+
+            int chunk = data->claimChunkNearest(preferred);
+            if (chunk < 0)
+                break;
+
+            if (!buildChunk(*reader, block, chunk))
+                break;
+
+            data->markChunkReady(chunk);
+            scheduler.sendChangeMessage();
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    bool shouldStop() { return shouldExit() || data->cancelled.load(std::memory_order_relaxed); }
+
+    bool buildChunk(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& block, int chunk)
+    {
+        int firstBucket = chunk * WaveformData::bucketsPerChunk;
+        int endBucket = juce::jmin(firstBucket + WaveformData::bucketsPerChunk, data->numBuckets);
+        auto spb = (juce::int64)data->samplesPerBucket;
+        auto chunkEnd = juce::jmin((juce::int64)endBucket * spb, data->lengthInSamples);
+
+        // reads are capped at the block size, so a bucket may span several of them;
+        // its min/max starts fresh on its first sample and accumulates after that
+        for (auto pos = (juce::int64)firstBucket * spb; pos < chunkEnd;)
+        {
+            if (shouldStop())
+                return false;
+
+            int numSamples = (int)juce::jmin((juce::int64)block.getNumSamples(), chunkEnd - pos);
+            reader.read(block.getArrayOfWritePointers(), data->numChannels, pos, numSamples);
+
+            for (int offset = 0; offset < numSamples;)
+            {
+                auto samplePos = pos + offset;
+                int bucket = (int)(samplePos / spb);
+                int count = (int)juce::jmin((juce::int64)(numSamples - offset), (bucket + 1) * spb - samplePos);
+                bool bucketStart = samplePos == bucket * spb;
+
+                for (int ch = 0; ch < data->numChannels; ++ch)
+                {
+                    auto range = juce::FloatVectorOperations::findMinAndMax(block.getReadPointer(ch, offset), count);
+                    auto index = (size_t)(ch * data->numBuckets + bucket);
+                    data->minPeaks[index] = bucketStart ? range.getStart() : juce::jmin(data->minPeaks[index], range.getStart());
+                    data->maxPeaks[index] = bucketStart ? range.getEnd() : juce::jmax(data->maxPeaks[index], range.getEnd());
+                }
+
+                offset += count;
+            }
+
+            pos += numSamples;
+        }
+
+        return true;
+    }
+
+    WaveformScheduler& scheduler;
+    WaveformData::Ptr data;
+
+    JUCE_DECLARE_NON_COPYABLE(BuildJob)
+};
+
+//==============================================================================
+WaveformScheduler::WaveformScheduler()
+    : pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))
+{
+    formatManager.registerBasicFormats();
+}
+
+WaveformScheduler::~WaveformScheduler()
+{
+    cancel();
+    pool.removeAllJobs(true, 2000);
+}
+
+WaveformData::Ptr WaveformScheduler::load(const juce::File& file, double startPositionSeconds)
+{
+    cancel();
+
+    if (!file.existsAsFile())
+        return nullptr;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    int channels = juce::jlimit(1, maxDisplayChannels, (int)reader->numChannels);
+    current = new WaveformData(file, channels, reader->lengthInSamples, reader->sampleRate);
+    current->playheadSeconds.store(startPositionSeconds);
+
+    auto layout = reader->getChannelLayout();
+    for (int ch = 0; ch < channels; ++ch)
+        current->channelNames.add(layout.size() == (int)reader->numChannels
+            ? juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(ch))
+            : juce::String(ch + 1));
+
+    // one job per core, but no more than there are chunks to share out
+    int numJobs = juce::jmin(pool.getNumThreads(), current->numChunks);
+    for (int i = 0; i < numJobs; ++i)
+        pool.addJob(new BuildJob(*this, current), true);
+
+    return current;
+}
+
+void WaveformScheduler::cancel()
+{
+    if (current != nullptr)
+        current->cancelled.store(true);
+
+    // don't wait: running jobs see the flag at their next read and bail out
+    pool.removeAllJobs(true, 0);
+    current = nullptr;
+}
+
+void WaveformScheduler::setPlayhead(double seconds)
+{
+    if (current != nullptr)
+        current->playheadSeconds.store(seconds, std::memory_order_relaxed);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// min/max peaks for one file, filled in chunk by chunk by the scheduler's workers.
+// A chunk's peaks may only be read once isChunkReady() returns true for it.
+class WaveformData : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<WaveformData>;
+
+    WaveformData(const juce::File& file, int numChannels, juce::int64 lengthInSamples, double sampleRate);
+
+    const juce::File file;
+    const int numChannels;
+    const juce::int64 lengthInSamples;
+    const double sampleRate;
+    const int samplesPerBucket;
+    const int numBuckets;
+    const int numChunks;
+
+    juce::StringArray channelNames;   // short layout names ("L", "C", "Ls", ...), one per channel
+
+    static constexpr int bucketsPerChunk = 256;
+
+    double getLengthInSeconds() const { return sampleRate > 0.0 ? lengthInSamples / sampleRate : 0.0; }
+
+    bool isChunkReady(int chunk) const { return chunkStates[(size_t)chunk].load(std::memory_order_acquire) == ready; }
+    bool isBucketReady(int bucket) const { return isChunkReady(bucket / bucketsPerChunk); }
+    bool isComplete() const { return chunksDone.load(std::memory_order_acquire) == numChunks; }
+    double getBuildTimeMs() const { return buildTimeMs.load(std::memory_order_acquire); }   // -1 until complete
+    float getProgress() const { return (float)chunksDone.load(std::memory_order_relaxed) / (float)numChunks; }
+
+    float getMin(int channel, int bucket) const { return minPeaks[(size_t)(channel * numBuckets + bucket)]; }
+    float getMax(int channel, int bucket) const { return maxPeaks[(size_t)(channel * numBuckets + bucket)]; }
+
+private:
+    friend class WaveformScheduler;
+
+    enum ChunkState { pending = 0, claimed, ready };
+
+    // picks the unclaimed chunk closest to the playhead, or -1 when none are left
+    int claimChunkNearest(int preferredChunk);
+    void markChunkReady(int chunk);
+
+    std::vector<float> minPeaks, maxPeaks;
+    std::vector<std::atomic<int>> chunkStates;
+    std::atomic<int> chunksDone{ 0 };
+    std::atomic<bool> cancelled{ false };
+    std::atomic<double> playheadSeconds{ 0.0 };
+    const double startedMs = juce::Time::getMillisecondCounterHiRes();
+    std::atomic<double> buildTimeMs{ -1.0 };
+};
+
+// Builds waveform peaks on a thread pool. Loading a new file cancels whatever
+// was being built for the previous one, and the workers fill chunks outward
+// from the playhead so the interesting part shows up first.
+class WaveformScheduler : public juce::ChangeBroadcaster
+{
+public:
+    WaveformScheduler();
+    ~WaveformScheduler() override;
+
+    // message thread; returns nullptr if the file can't be read
+    WaveformData::Ptr load(const juce::File& file, double startPositionSeconds = 0.0);
+    void cancel();
+
+    // steers remaining chunks towards the current position
+    void setPlayhead(double seconds);
+
+    WaveformData::Ptr getCurrent() const { return current; }
+
+private:
+    class BuildJob;
+
+    juce::AudioFormatManager formatManager;
+    juce::ThreadPool pool;
+    WaveformData::Ptr current;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformScheduler)
+};